@@ -0,0 +1,437 @@
+// An end-to-end benchmark for the Lawson local optimization procedure
+// (LOP) that turns a triangulation into the PD-Delaunay triangulation.
+// Each run generates a point set and an initial triangulation of it with
+// one of the generators below, runs ra::geometry::make_pd_delaunay on
+// it, and reports the time taken, the numbers of passes, edge tests, and
+// flips, the fraction of predicates that needed exact arithmetic, and
+// the peak resident set size.
+// The generators are:
+//   random        uniformly distributed points, scan triangulation
+//   grid          points on a square grid (highly cocircular), scan
+//                 triangulation; the origin has many significant bits, so
+//                 that the cocircular cases need exact arithmetic
+//   integer_grid  as grid, but with integer coordinates (so that the
+//                 kernel uses integer arithmetic)
+//   clustered     normally distributed clusters of points, scan
+//                 triangulation
+//   fan           points in convex position on an ellipse, triangulated
+//                 as a fan from one vertex (the LOP needs a quadratic
+//                 number of flips on this input)
+// The scan triangulation adds the points in lexicographic order and
+// connects each one to the visible edges of the convex hull, which gives
+// many long and thin triangles.
+// Usage: bench_delaunay [--perf] [generator [size...]]
+// With --perf, the performance counters of ra::profiling::perf_counters
+// (where available) and the rounding-mode changes and exceptions of the
+// interval arithmetic are also reported for each phase of a run: the
+// generation of the input, the construction of the triangulation, the
+// first pass of the LOP (which tests every edge), and the later passes.
+// Each run is made in a separate process, so that the peak resident set
+// size is that of the run alone.
+#include "triangulation_2.hpp"
+#include "ra/kernel.hpp"
+#include "ra/lop.hpp"
+#include "ra/perf_counters.hpp"
+#include "ra/pool_allocator.hpp"
+#include <CGAL/Cartesian.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using Kernel = CGAL::Cartesian<double>;
+using Triangulation = trilib::Triangulation_2<Kernel,
+  ra::memory::pool_allocator<int>>;
+using Point = Kernel::Point_2;
+using Triangle = std::array<int, 3>;
+
+namespace {
+
+bool ccw(const Point& a, const Point& b, const Point& c)
+{
+  ra::geometry::Kernel<double> kernel;
+  return kernel.orientation(a, b, c) ==
+    ra::geometry::Kernel<double>::Orientation::left_turn;
+}
+
+bool cw(const Point& a, const Point& b, const Point& c)
+{
+  ra::geometry::Kernel<double> kernel;
+  return kernel.orientation(a, b, c) ==
+    ra::geometry::Kernel<double>::Orientation::right_turn;
+}
+
+// Triangulate the points by adding them in lexicographic order and
+// connecting each point to the edges of the convex hull that it sees.
+// Duplicate points are removed.  Returns false if the points are all
+// collinear.
+bool scan_triangulate(std::vector<Point>& points,
+  std::vector<Triangle>& triangles)
+{
+  std::sort(points.begin(), points.end(), [](const Point& a,
+    const Point& b) {
+    return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+  });
+  points.erase(std::unique(points.begin(), points.end()), points.end());
+  const int n = int(points.size());
+
+  // Find the first point that is not collinear with the ones before it,
+  // and connect it to all of them.
+  int k = 2;
+  while (k < n && !ccw(points[0], points[k - 1], points[k]) &&
+    !cw(points[0], points[k - 1], points[k]))
+  {
+    ++k;
+  }
+  if (k >= n)
+  {
+    return false;
+  }
+  // The lower and upper convex hull chains, both ending at the most
+  // recently added point.
+  std::vector<int> lower;
+  std::vector<int> upper;
+  const bool above = ccw(points[0], points[k - 1], points[k]);
+  for (int i = 0; i < k; ++i)
+  {
+    (above ? lower : upper).push_back(i);
+    if (i + 1 < k)
+    {
+      triangles.push_back(above ? Triangle{i, i + 1, k} :
+        Triangle{i + 1, i, k});
+    }
+  }
+  (above ? upper : lower).push_back(0);
+  lower.push_back(k);
+  upper.push_back(k);
+
+  for (int p = k + 1; p < n; ++p)
+  {
+    while (lower.size() >= 2 && cw(points[lower[lower.size() - 2]],
+      points[lower.back()], points[p]))
+    {
+      triangles.push_back({lower[lower.size() - 2], p, lower.back()});
+      lower.pop_back();
+    }
+    lower.push_back(p);
+    while (upper.size() >= 2 && ccw(points[upper[upper.size() - 2]],
+      points[upper.back()], points[p]))
+    {
+      triangles.push_back({upper[upper.size() - 2], upper.back(), p});
+      upper.pop_back();
+    }
+    upper.push_back(p);
+  }
+  return true;
+}
+
+// Generate n points and a triangulation of them with the named
+// generator.  Returns false if the generator is unknown or the points are
+// all collinear.
+bool generate(const std::string& generator, std::size_t n,
+  std::vector<Point>& points, std::vector<Triangle>& triangles)
+{
+  std::mt19937_64 random(1);
+  std::uniform_real_distribution<double> uniform(0, 1);
+  points.clear();
+  triangles.clear();
+  if (generator == "random")
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      points.emplace_back(uniform(random), uniform(random));
+    }
+  }
+  else if (generator == "grid")
+  {
+    // The origin is a multiple of 2^-40, so the grid points are exact.
+    const double origin = std::ldexp(double(random() >> 24), -40);
+    const int m = int(std::ceil(std::sqrt(double(n))));
+    for (int i = 0; i < m; ++i)
+    {
+      for (int j = 0; j < m; ++j)
+      {
+        points.emplace_back(origin + i, origin + j);
+      }
+    }
+  }
+  else if (generator == "integer_grid")
+  {
+    const int m = int(std::ceil(std::sqrt(double(n))));
+    for (int i = 0; i < m; ++i)
+    {
+      for (int j = 0; j < m; ++j)
+      {
+        points.emplace_back(i, j);
+      }
+    }
+  }
+  else if (generator == "clustered")
+  {
+    const std::size_t clusters = std::max<std::size_t>(1,
+      std::size_t(std::sqrt(double(n)) / 4));
+    std::vector<Point> centers;
+    for (std::size_t i = 0; i < clusters; ++i)
+    {
+      centers.emplace_back(uniform(random), uniform(random));
+    }
+    std::normal_distribution<double> normal(0, 0.5 / double(clusters));
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const Point& c = centers[random() % clusters];
+      points.emplace_back(c.x() + normal(random), c.y() + normal(random));
+    }
+  }
+  else if (generator == "fan")
+  {
+    const double pi = std::acos(-1.0);
+    std::vector<double> angles;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      angles.push_back(2 * pi * uniform(random));
+    }
+    std::sort(angles.begin(), angles.end());
+    angles.erase(std::unique(angles.begin(), angles.end()), angles.end());
+    for (double angle : angles)
+    {
+      points.emplace_back(2 * std::cos(angle), std::sin(angle));
+    }
+    for (int i = 1; i + 1 < int(points.size()); ++i)
+    {
+      triangles.push_back({0, i, i + 1});
+    }
+    return !triangles.empty();
+  }
+  else
+  {
+    return false;
+  }
+  return scan_triangulate(points, triangles);
+}
+
+// The performance counters and the interval-arithmetic counts of the
+// phases of a run (if enabled).
+class Phase_profile
+{
+public:
+  explicit Phase_profile(bool enabled)
+  {
+    if (enabled)
+    {
+      counters_.emplace();
+    }
+  }
+
+  // Start a phase.
+  // Precondition: The kernel statistics are not cleared until the phase
+  // ends.
+  void start()
+  {
+    if (counters_)
+    {
+      start_ = counters_->read();
+      ra::geometry::Kernel<double>::get_statistics(start_statistics_);
+    }
+  }
+
+  // End the phase started last, with the given name.
+  void end(const char* name)
+  {
+    if (counters_)
+    {
+      ra::geometry::Kernel<double>::Statistics statistics;
+      ra::geometry::Kernel<double>::get_statistics(statistics);
+      phases_.push_back({name, counters_->read() - start_,
+        statistics.rounding_mode_change_count -
+        start_statistics_.rounding_mode_change_count,
+        statistics.exception_count - start_statistics_.exception_count});
+    }
+  }
+
+  // Print the counts of the phases.
+  void print() const
+  {
+    if (!counters_)
+    {
+      return;
+    }
+    using ra::profiling::perf_counters;
+    std::printf("  %-14s", "phase");
+    for (int e = 0; e < perf_counters::event_count; ++e)
+    {
+      std::printf(" %14s", perf_counters::name(e));
+    }
+    std::printf(" %14s %14s\n", "roundings", "exceptions");
+    for (const Phase& phase : phases_)
+    {
+      std::printf("  %-14s", phase.name);
+      for (int e = 0; e < perf_counters::event_count; ++e)
+      {
+        if (counters_->available(e))
+        {
+          std::printf(" %14llu", (unsigned long long)phase.counts[e]);
+        }
+        else
+        {
+          std::printf(" %14s", "-");
+        }
+      }
+      std::printf(" %14zu %14zu\n", phase.rounding_mode_changes,
+        phase.exceptions);
+    }
+  }
+
+private:
+  struct Phase
+  {
+    const char* name;
+    ra::profiling::perf_counters::reading counts;
+    std::size_t rounding_mode_changes;
+    std::size_t exceptions;
+  };
+
+  std::optional<ra::profiling::perf_counters> counters_;
+  ra::profiling::perf_counters::reading start_ = {};
+  ra::geometry::Kernel<double>::Statistics start_statistics_ = {};
+  std::vector<Phase> phases_;
+};
+
+// Generate the input with the named generator, run the LOP on it, and
+// print the results.
+bool run(const std::string& generator, std::size_t n, bool perf)
+{
+  Phase_profile profile(perf);
+  std::vector<Point> points;
+  std::vector<Triangle> triangles;
+  profile.start();
+  if (!generate(generator, n, points, triangles))
+  {
+    std::fprintf(stderr, "cannot generate %s input\n", generator.c_str());
+    return false;
+  }
+  profile.end("generate");
+
+  profile.start();
+  Triangulation tri(points, triangles);
+  points = std::vector<Point>();
+  triangles = std::vector<Triangle>();
+  profile.end("build");
+
+  const Kernel::Vector_2 u(1, 0);
+  const Kernel::Vector_2 v(1, 1);
+  ra::geometry::Kernel<double>::clear_statistics();
+  profile.start();
+  const auto start = std::chrono::steady_clock::now();
+  const ra::geometry::Lop_statistics lop = ra::geometry::make_pd_delaunay(
+    tri, u, v, [&](const ra::geometry::Lop_pass& pass) {
+      if (pass.pass == 1)
+      {
+        profile.end("first pass");
+        profile.start();
+      }
+    });
+  profile.end("later passes");
+  const double seconds = std::chrono::duration<double>(
+    std::chrono::steady_clock::now() - start).count();
+
+  ra::geometry::Kernel<double>::Statistics stats;
+  ra::geometry::Kernel<double>::get_statistics(stats);
+  const std::size_t total = stats.orientation_total_count +
+    stats.side_of_oriented_circle_total_count +
+    stats.preferred_direction_total_count;
+  const std::size_t exact = stats.orientation_exact_count +
+    stats.side_of_oriented_circle_exact_count +
+    stats.preferred_direction_exact_count;
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+
+  std::printf(
+    "%-12s %10d %10d %10.3f %12zu %7zu %12zu %8.3f%% %10.1f\n",
+    generator.c_str(), tri.size_of_vertices(), tri.size_of_faces(),
+    seconds, lop.flips, lop.passes, lop.tests,
+    total > 0 ? 100.0 * double(exact) / double(total) : 0.0,
+    double(usage.ru_maxrss) / 1024);
+  profile.print();
+  std::fflush(stdout);
+  return true;
+}
+
+// Make the run in a child process.
+bool run_in_child(const std::string& generator, std::size_t n,
+  bool perf)
+{
+  std::fflush(stdout);
+  const pid_t pid = fork();
+  if (pid < 0)
+  {
+    return run(generator, n, perf);
+  }
+  if (pid == 0)
+  {
+    std::_Exit(run(generator, n, perf) ? 0 : 1);
+  }
+  int status;
+  return waitpid(pid, &status, 0) == pid && WIFEXITED(status) &&
+    WEXITSTATUS(status) == 0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  std::vector<std::string> generators = {"random", "grid", "integer_grid",
+    "clustered", "fan"};
+  std::vector<std::size_t> sizes;
+  bool perf = false;
+  int first = 1;
+  for (; argc > first && std::string(argv[first]).rfind("--", 0) == 0;
+    ++first)
+  {
+    const std::string option = argv[first];
+    if (option == "--perf")
+    {
+      perf = true;
+    }
+    else
+    {
+      std::fprintf(stderr, "unknown option %s\n", option.c_str());
+      return 1;
+    }
+  }
+  if (argc > first)
+  {
+    generators = {argv[first]};
+  }
+  for (int i = first + 1; i < argc; ++i)
+  {
+    sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+  }
+
+  std::printf("%-12s %10s %10s %10s %12s %7s %12s %9s %10s\n",
+    "generator", "vertices", "faces", "time (s)", "flips", "passes",
+    "tests", "exact", "RSS (MB)");
+  bool ok = true;
+  for (const auto& generator : generators)
+  {
+    std::vector<std::size_t> default_sizes = {1000, 10000, 100000};
+    if (generator == "fan")
+    {
+      default_sizes = {1000, 3000, 10000};
+    }
+    for (std::size_t n : sizes.empty() ? default_sizes : sizes)
+    {
+      ok = run_in_child(generator, n, perf) && ok;
+    }
+  }
+  return ok ? 0 : 1;
+}
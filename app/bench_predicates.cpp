@@ -0,0 +1,431 @@
+// Micro-benchmarks for the interval arithmetic and the kernel predicates.
+// Each benchmark repeats one operation over a fixed set of inputs of one
+// kind (random, near-degenerate, or exactly degenerate) and reports the
+// average time per operation and, for the predicates, the fractions of
+// calls for which the interval filter failed and double-double arithmetic
+// was used, and for which that failed too and exact arithmetic was used
+// (as reported by Kernel::get_statistics).
+// Usage: bench_predicates [--perf] [filter]
+// Only the benchmarks whose names contain filter are run.
+// With --perf, the performance counters of ra::profiling::perf_counters
+// (where available) and the rounding-mode changes and exceptions of the
+// interval arithmetic are also reported per operation, as these have
+// costs that the time alone does not explain.
+// Build with optimization (e.g., CMAKE_BUILD_TYPE=Release) to get
+// meaningful timings.
+#include "ra/interval.hpp"
+#include "ra/kernel.hpp"
+#include "ra/perf_counters.hpp"
+#include <CGAL/Cartesian.h>
+#include <algorithm>
+#include <array>
+#include <cfenv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+using Kernel = ra::geometry::Kernel<double>;
+using Point = Kernel::Point;
+using Vector = Kernel::Vector;
+using Interval = ra::math::interval<double>;
+
+namespace {
+
+// The number of inputs generated for each benchmark.
+constexpr std::size_t input_count = 4096;
+// The minimum time (in seconds) for which each benchmark is run.
+constexpr double min_time = 0.25;
+
+// Results are accumulated here so that the compiler cannot discard the
+// benchmarked operations.
+volatile double sink;
+
+std::mt19937_64 generator(1);
+
+// The performance counters, if they are reported.
+std::optional<ra::profiling::perf_counters> counters;
+
+// Get a random number in [0, 1).
+double random_real()
+{
+  return std::uniform_real_distribution<double>(0, 1)(generator);
+}
+
+// Get a random multiple of 2^-bits in [0, 1).
+// Sums and differences of such numbers are exact, so they can be used to
+// build exactly degenerate inputs whose predicates still overflow the
+// precision of double (and thus defeat the interval filter).
+double random_dyadic(int bits = 40)
+{
+  const std::uint64_t k = generator() >> (64 - bits);
+  return std::ldexp(double(k), -bits);
+}
+
+// Get the point p moved by one unit in the last place in x.
+Point perturb(const Point& p)
+{
+  return Point(std::nextafter(p.x(), 2.0), p.y());
+}
+
+// Run f(n), which must perform n operations, for at least min_time
+// seconds and print the average time per operation.
+template <class F>
+void run(const std::string& name, const std::string& filter, F f,
+  bool is_predicate = true)
+{
+  if (name.find(filter) == std::string::npos)
+  {
+    return;
+  }
+  std::size_t iterations = 1;
+  double seconds = 0;
+  ra::profiling::perf_counters::reading counts = {};
+  for (;;)
+  {
+    Kernel::clear_statistics();
+    const auto before = counters ? counters->read() :
+      ra::profiling::perf_counters::reading{};
+    const auto start = std::chrono::steady_clock::now();
+    f(iterations);
+    seconds = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - start).count();
+    if (counters)
+    {
+      counts = counters->read() - before;
+    }
+    if (seconds >= min_time || iterations >= (std::size_t(1) << 40))
+    {
+      break;
+    }
+    // Aim a little beyond the minimum time, as Google Benchmark does.
+    const double factor = seconds > 0 ? 1.4 * min_time / seconds : 10;
+    iterations = std::size_t(double(iterations) *
+      std::clamp(factor, 2.0, 10.0));
+  }
+
+  Kernel::Statistics stats;
+  Kernel::get_statistics(stats);
+  const std::size_t total = stats.orientation_total_count +
+    stats.side_of_oriented_circle_total_count +
+    stats.preferred_direction_total_count;
+  const std::size_t double_double = stats.orientation_double_double_count +
+    stats.side_of_oriented_circle_double_double_count +
+    stats.preferred_direction_double_double_count;
+  const std::size_t exact = stats.orientation_exact_count +
+    stats.side_of_oriented_circle_exact_count +
+    stats.preferred_direction_exact_count;
+  if (is_predicate && total > 0)
+  {
+    std::printf("%-40s %12.2f ns %12zu %10.2f%% %10.2f%%\n", name.c_str(),
+      1e9 * seconds / double(iterations), iterations,
+      100.0 * double(double_double) / double(total),
+      100.0 * double(exact) / double(total));
+  }
+  else
+  {
+    std::printf("%-40s %12.2f ns %12zu %11s %11s\n", name.c_str(),
+      1e9 * seconds / double(iterations), iterations, "-", "-");
+  }
+  if (counters)
+  {
+    // The counts per operation.
+    std::printf("  ");
+    for (int e = 0; e < ra::profiling::perf_counters::event_count; ++e)
+    {
+      if (counters->available(e))
+      {
+        std::printf(" %s %.2f", ra::profiling::perf_counters::name(e),
+          double(counts[e]) / double(iterations));
+      }
+      else
+      {
+        std::printf(" %s -", ra::profiling::perf_counters::name(e));
+      }
+    }
+    std::printf(" rounding-mode-changes %.2f exceptions %.2f\n",
+      double(stats.rounding_mode_change_count) / double(iterations),
+      double(stats.exception_count) / double(iterations));
+  }
+}
+
+void interval_benchmarks(const std::string& filter)
+{
+  std::vector<Interval> a;
+  std::vector<Interval> b;
+  for (std::size_t i = 0; i < input_count; ++i)
+  {
+    a.emplace_back(random_real(), random_real());
+    b.emplace_back(random_real(), random_real());
+  }
+  run("interval_add", filter, [&](std::size_t n) {
+    double sum = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      sum += (a[i % input_count] + b[i % input_count]).lower();
+    }
+    sink = sum;
+  }, false);
+  run("interval_sub", filter, [&](std::size_t n) {
+    double sum = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      sum += (a[i % input_count] - b[i % input_count]).lower();
+    }
+    sink = sum;
+  }, false);
+  run("interval_mul", filter, [&](std::size_t n) {
+    double sum = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      sum += (a[i % input_count] * b[i % input_count]).lower();
+    }
+    sink = sum;
+  }, false);
+
+  // The orientation determinant of intervals, as an interval expression
+  // and written out by hand (with the same rounding, see
+  // ra::math::interval_expression), which it should match in speed.
+  std::vector<std::array<Interval, 6>> points;
+  for (std::size_t i = 0; i < input_count; ++i)
+  {
+    points.push_back({Interval(random_real()), Interval(random_real()),
+      Interval(random_real()), Interval(random_real()),
+      Interval(random_real()), Interval(random_real())});
+  }
+  run("interval_orientation_det/expression", filter, [&](std::size_t n) {
+    double sum = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const auto& [xa, ya, xb, yb, xc, yc] = points[i % input_count];
+      const Interval det = (xa - xc) * (yb - yc) - (xb - xc) * (ya - yc);
+      sum += det.lower();
+    }
+    sink = sum;
+  }, false);
+  run("interval_orientation_det/hand_written", filter, [&](std::size_t n) {
+    using ra::math::opacify;
+    // The negated lower bound and the upper bound of a - b and a * b,
+    // rounded upward.
+    const auto sub = [](const double* a, const double* b, double* r) {
+      r[0] = opacify(opacify(a[0]) + opacify(b[1]));
+      r[1] = opacify(opacify(a[1]) + opacify(b[0]));
+    };
+    const auto mul = [](const double* a, const double* b, double* r) {
+      const auto m = [](double x, double y) {
+        return opacify(opacify(x) * opacify(y));
+      };
+      r[0] = std::max({m(a[0], -b[0]), m(a[0], b[1]), m(-a[1], -b[0]),
+        m(-a[1], b[1])});
+      r[1] = std::max({m(-a[0], -b[0]), m(-a[0], b[1]), m(a[1], -b[0]),
+        m(a[1], b[1])});
+    };
+    double sum = 0;
+    ra::math::rounding_mode_saver rms;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      double p[6][2];
+      for (int j = 0; j < 6; ++j)
+      {
+        p[j][0] = -points[i % input_count][j].lower();
+        p[j][1] = points[i % input_count][j].upper();
+      }
+      rms.round_up();
+      double d[4][2], e[3][2];
+      sub(p[0], p[4], d[0]);
+      sub(p[3], p[5], d[1]);
+      sub(p[2], p[4], d[2]);
+      sub(p[1], p[5], d[3]);
+      mul(d[0], d[1], e[0]);
+      mul(d[2], d[3], e[1]);
+      sub(e[0], e[1], e[2]);
+      std::fesetround(FE_TONEAREST);
+      sum += -e[2][0];
+    }
+    sink = sum;
+  }, false);
+}
+
+void orientation_benchmark(const std::string& name,
+  const std::string& filter, const std::vector<std::array<Point, 3>>& input)
+{
+  run(name, filter, [&](std::size_t n) {
+    Kernel kernel;
+    int sum = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const auto& p = input[i % input.size()];
+      sum += int(kernel.orientation(p[0], p[1], p[2]));
+    }
+    sink = sum;
+  });
+}
+
+void orientation_benchmarks(const std::string& filter)
+{
+  std::vector<std::array<Point, 3>> random;
+  std::vector<std::array<Point, 3>> near;
+  std::vector<std::array<Point, 3>> degenerate;
+  for (std::size_t i = 0; i < input_count; ++i)
+  {
+    random.push_back({Point(random_real(), random_real()),
+      Point(random_real(), random_real()),
+      Point(random_real(), random_real())});
+    // A point within a few units in the last place of (0.5, 0.5), which
+    // is on the line through (12, 12) and (24, 24).
+    near.push_back({Point(0.5 + std::ldexp(double(generator() % 256), -53),
+      0.5 + std::ldexp(double(generator() % 256), -53)),
+      Point(12, 12), Point(24, 24)});
+    const double x = random_dyadic();
+    const double y = random_dyadic();
+    degenerate.push_back({Point(x, y), Point(2 * x, 2 * y),
+      Point(3 * x, 3 * y)});
+  }
+  orientation_benchmark("orientation/random", filter, random);
+  orientation_benchmark("orientation/near_degenerate", filter, near);
+  orientation_benchmark("orientation/degenerate", filter, degenerate);
+}
+
+void side_of_oriented_circle_benchmark(const std::string& name,
+  const std::string& filter, const std::vector<std::array<Point, 4>>& input)
+{
+  run(name, filter, [&](std::size_t n) {
+    Kernel kernel;
+    int sum = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const auto& p = input[i % input.size()];
+      sum += int(kernel.side_of_oriented_circle(p[0], p[1], p[2], p[3]));
+    }
+    sink = sum;
+  });
+}
+
+void side_of_oriented_circle_benchmarks(const std::string& filter)
+{
+  // The lattice points on a circle with many of them.
+  constexpr int radius = 5525;
+  std::vector<std::array<int, 2>> lattice;
+  for (int x = -radius; x <= radius; ++x)
+  {
+    const int y = int(std::lround(std::sqrt(double(radius) * radius -
+      double(x) * x)));
+    if (x * x + y * y == radius * radius)
+    {
+      lattice.push_back({x, y});
+      if (y != 0)
+      {
+        lattice.push_back({x, -y});
+      }
+    }
+  }
+
+  std::vector<std::array<Point, 4>> random;
+  std::vector<std::array<Point, 4>> near;
+  std::vector<std::array<Point, 4>> degenerate;
+  for (std::size_t i = 0; i < input_count; ++i)
+  {
+    random.push_back({Point(random_real(), random_real()),
+      Point(random_real(), random_real()),
+      Point(random_real(), random_real()),
+      Point(random_real(), random_real())});
+    // Four distinct lattice points on the circle, scaled by a factor that
+    // keeps the coordinates exact but makes their squares inexact.
+    std::array<std::size_t, 4> k;
+    for (std::size_t j = 0; j < 4; ++j)
+    {
+      do
+      {
+        k[j] = generator() % lattice.size();
+      } while (std::find(k.begin(), k.begin() + j, k[j]) != k.begin() + j);
+    }
+    const double scale = 1 + random_dyadic(20);
+    std::array<Point, 4> p;
+    for (std::size_t j = 0; j < 4; ++j)
+    {
+      p[j] = Point(scale * lattice[k[j]][0], scale * lattice[k[j]][1]);
+    }
+    degenerate.push_back(p);
+    p[3] = perturb(p[3]);
+    near.push_back(p);
+  }
+  side_of_oriented_circle_benchmark("side_of_oriented_circle/random", filter,
+    random);
+  side_of_oriented_circle_benchmark(
+    "side_of_oriented_circle/near_degenerate", filter, near);
+  side_of_oriented_circle_benchmark("side_of_oriented_circle/degenerate",
+    filter, degenerate);
+}
+
+void preferred_direction_benchmark(const std::string& name,
+  const std::string& filter, const std::vector<std::array<Point, 4>>& input)
+{
+  const Vector v(1, 0);
+  run(name, filter, [&](std::size_t n) {
+    Kernel kernel;
+    int sum = 0;
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      const auto& p = input[i % input.size()];
+      sum += kernel.preferred_direction(p[0], p[1], p[2], p[3], v);
+    }
+    sink = sum;
+  });
+}
+
+void preferred_direction_benchmarks(const std::string& filter)
+{
+  std::vector<std::array<Point, 4>> random;
+  std::vector<std::array<Point, 4>> near;
+  std::vector<std::array<Point, 4>> degenerate;
+  for (std::size_t i = 0; i < input_count; ++i)
+  {
+    random.push_back({Point(random_real(), random_real()),
+      Point(random_real(), random_real()),
+      Point(random_real(), random_real()),
+      Point(random_real(), random_real())});
+    // The segments ab and cd are mirror images of each other with respect
+    // to the direction (1, 0), so they are equally close to it.
+    const double dx = random_dyadic();
+    const double dy = random_dyadic();
+    const Point a(random_dyadic(), random_dyadic());
+    const Point c(random_dyadic(), random_dyadic());
+    std::array<Point, 4> p = {a, Point(a.x() + dx, a.y() + dy), c,
+      Point(c.x() + dx, c.y() - dy)};
+    degenerate.push_back(p);
+    p[3] = perturb(p[3]);
+    near.push_back(p);
+  }
+  preferred_direction_benchmark("preferred_direction/random", filter,
+    random);
+  preferred_direction_benchmark("preferred_direction/near_degenerate",
+    filter, near);
+  preferred_direction_benchmark("preferred_direction/degenerate", filter,
+    degenerate);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  int first = 1;
+  if (argc > first && std::string(argv[first]) == "--perf")
+  {
+    counters.emplace();
+    ++first;
+  }
+  const std::string filter = argc > first ? argv[first] : "";
+  std::printf("%-40s %15s %12s %11s %11s\n", "Benchmark", "Time",
+    "Iterations", "Double-dbl", "Exact");
+  std::printf("%s\n", std::string(93, '-').c_str());
+  interval_benchmarks(filter);
+  orientation_benchmarks(filter);
+  side_of_oriented_circle_benchmarks(filter);
+  preferred_direction_benchmarks(filter);
+  return 0;
+}
@@ -1,131 +1,597 @@
 #include "triangulation_2.hpp"
 #include "ra/kernel.hpp"
+#include "ra/incremental_delaunay.hpp"
+#include "ra/divide_and_conquer_delaunay.hpp"
+#include "ra/lop.hpp"
+#include "ra/pd_delaunay_check.hpp"
+#include "ra/pool_allocator.hpp"
+#include "ra/voronoi.hpp"
 #include <CGAL/Cartesian.h>
 #include <CGAL/Cartesian.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
 #include <string>
 #include <iostream>
-#include <map>
+#include <limits>
+#include <mutex>
+#include <thread>
 #include <utility>
+#include <vector>
+#include <sys/resource.h>
 
 using Kernel = CGAL::Cartesian<double>;
-using Triangulation = trilib::Triangulation_2<Kernel>;
-using Suspect_Map = std::map<Triangulation::Halfedge_const_handle, int>;
+using Triangulation = trilib::Triangulation_2<Kernel,
+  ra::memory::pool_allocator<int>>;
 
-Suspect_Map suspects;
-
-bool is_flippable(Triangulation::Halfedge_const_handle halfedge)
+// Read a point set in OFF format from in.
+// Only the vertices are used; any faces in the input are ignored.
+bool read_points(std::istream& in, std::vector<Kernel::Point_2>& points)
 {
-  return !(halfedge->is_border() || halfedge->opposite()->is_border());
+  std::string signature;
+  int num_vertices;
+  int num_faces;
+  int num_edges;
+  if (!(in >> signature) || signature != "OFF" ||
+    !(in >> num_vertices >> num_faces >> num_edges))
+  {
+    std::cerr << "not OFF format\n";
+    return false;
+  }
+  points.clear();
+  points.reserve(num_vertices);
+  for (int i = 0; i < num_vertices; ++i)
+  {
+    double x;
+    double y;
+    double z;
+    if (!(in >> x >> y >> z))
+    {
+      std::cerr << "cannot get vertex\n";
+      return false;
+    }
+    points.emplace_back(x, y);
+  }
+  return true;
 }
 
+// Build the PD-Delaunay triangulation of the points read from in with
+// the triangulator delaunay (e.g., ra::geometry::Incremental_delaunay).
+// The vertices and the faces (as indices into vertices) of the
+// triangulation are stored in vertices and triangles.
+template <class Triangulator>
+bool construct(std::istream& in, Triangulator& delaunay,
+  std::vector<Kernel::Point_2>& vertices,
+  std::vector<typename Triangulator::Triangle>& triangles)
+{
+  std::vector<Kernel::Point_2> points;
+  if (!read_points(in, points))
+  {
+    return false;
+  }
+  if (!delaunay.triangulate(points, vertices, triangles))
+  {
+    std::cerr << "points are collinear\n";
+    return false;
+  }
+  return true;
+}
 
-void mark_edges(Triangulation::Halfedge_const_handle edge)
+// Write the Voronoi diagram dual to tri to out.
+// The output has a line with the numbers of vertices and edges, a line
+// "x y x_error y_error" for each vertex, and for each edge a line
+// "e s t" (a segment between the vertices s and t) or "r s dx dy" (a ray
+// from the vertex s in the direction (dx, dy)).
+bool output_voronoi(const Triangulation& tri, std::ostream& out)
 {
-  if(is_flippable(edge))
+  const auto diagram = ra::geometry::make_voronoi_diagram(tri);
+  out << diagram.vertices.size() << " " << diagram.edges.size() << "\n";
+  for (const auto& v : diagram.vertices)
+  {
+    out << v.point.x() << " " << v.point.y() << " " << v.x_error << " "
+      << v.y_error << "\n";
+  }
+  for (const auto& e : diagram.edges)
   {
-    suspects[edge] = 0;
-    suspects[edge->opposite()] = 0;
+    if (e.target >= 0)
+    {
+      out << "e " << e.source << " " << e.target << "\n";
+    }
+    else
+    {
+      out << "r " << e.source << " " << e.direction.x() << " "
+        << e.direction.y() << "\n";
+    }
   }
+  return bool(out);
 }
 
-//find neighboring faces, return edges associated
-void mark_potential_suspects(const Triangulation& tri, Triangulation::Halfedge_const_handle flippedEdge)
+// Write the memory footprint of the triangulation (see
+// Triangulation_2::memory_footprint), along with the peak bytes of the
+// suspect lists of the LOP (see Lop_statistics), to out as JSON.  The
+// construction overhead is freed before the LOP runs, so the peak is that
+// of the larger of the two.
+void write_memory_footprint_json(const Triangulation& tri,
+  std::size_t lop_bytes, std::ostream& out)
 {
-	for (auto faceIter = tri.faces_begin(); faceIter != tri.faces_end();
-	  ++faceIter) {
-		Triangulation::Halfedge_const_handle h = faceIter->halfedge();
-		Triangulation::Vertex_const_handle a = h->vertex();
-		Triangulation::Vertex_const_handle b = h->opposite()->vertex();
-		Triangulation::Vertex_const_handle c = h->next()->vertex();
-		// std::cout << "face " << a->point() << ' ' << b->point() << ' '
-		//   << c->point() << '\n';
-
-      if(h == flippedEdge)
+  const auto footprint = tri.memory_footprint();
+  out << "{\"vertices\": " << footprint.vertices
+    << ", \"halfedges\": " << footprint.halfedges
+    << ", \"faces\": " << footprint.faces
+    << ", \"bytes_per_vertex\": " << footprint.vertex_bytes
+    << ", \"point_bytes_per_vertex\": " << footprint.point_bytes
+    << ", \"bytes_per_halfedge\": " << footprint.halfedge_bytes
+    << ", \"bytes_per_face\": " << footprint.face_bytes
+    << ", \"total_bytes\": " << footprint.total_bytes()
+    << ", \"construction_overhead_bytes\": " << footprint.construction_bytes
+    << ", \"construction_peak_bytes\": "
+    << footprint.total_bytes() + footprint.construction_bytes
+    << ", \"lop_suspect_bytes\": " << lop_bytes
+    << ", \"peak_bytes\": " << footprint.total_bytes() +
+    std::max(footprint.construction_bytes, lop_bytes) << "}\n";
+}
+
+// Writes progress telemetry to a stream as JSON lines: an object for the
+// end of each phase of the program and for the end of each pass of the
+// LOP.  Each object has the time taken by the phase or pass, the time
+// elapsed since the start of the program, and the peak resident set size
+// so far; a pass also has its Lop_pass counts and the (cumulative) kernel
+// and interval statistics.
+class Telemetry
+{
+  public:
+    // Write to out, or nowhere if out is null.
+    explicit Telemetry(std::ostream* out) : out_(out),
+      start_(std::chrono::steady_clock::now()), phase_start_(start_),
+      last_(start_) { }
+
+    // Record the end of the named phase, which began at the end of the
+    // previous one.
+    void phase(const char* name)
+    {
+      const auto now = std::chrono::steady_clock::now();
+      if (out_)
+      {
+        *out_ << "{\"event\": \"phase\", \"phase\": \"" << name
+          << "\", \"seconds\": " << seconds(phase_start_, now);
+        finish(now);
+      }
+      phase_start_ = now;
+      last_ = now;
+    }
+
+    // Record the end of a pass of the LOP.
+    void pass(const ra::geometry::Lop_pass& pass)
+    {
+      const auto now = std::chrono::steady_clock::now();
+      if (out_)
       {
-        mark_edges(h->next());
-        mark_edges(h->next()->next());
-        mark_edges(h->opposite()->next());
-        mark_edges(h->opposite()->next()->next());
+        ra::geometry::Kernel<double>::Statistics kernel;
+        ra::geometry::Kernel<double>::get_statistics(kernel);
+        ra::math::interval<double>::statistics interval;
+        ra::math::interval<double>::get_statistics(interval);
+        *out_ << "{\"event\": \"pass\", \"pass\": " << pass.pass
+          << ", \"tests\": " << pass.tests << ", \"flips\": " << pass.flips
+          << ", \"suspects\": " << pass.suspects << ", \"seconds\": "
+          << seconds(last_, now)
+          << ", \"orientation\": {\"total\": "
+          << kernel.orientation_total_count << ", \"exact\": "
+          << kernel.orientation_exact_count << "}"
+          << ", \"side_of_oriented_circle\": {\"total\": "
+          << kernel.side_of_oriented_circle_total_count << ", \"exact\": "
+          << kernel.side_of_oriented_circle_exact_count << "}"
+          << ", \"preferred_direction\": {\"total\": "
+          << kernel.preferred_direction_total_count << ", \"exact\": "
+          << kernel.preferred_direction_exact_count << "}"
+          << ", \"interval\": {\"operations\": "
+          << interval.arithmetic_op_count << ", \"indeterminate\": "
+          << interval.indeterminate_result_count
+          << ", \"rounding_mode_changes\": "
+          << interval.rounding_mode_change_count << "}";
+        finish(now);
       }
-	}
+      last_ = now;
+    }
+
+  private:
+    using Time_point = std::chrono::steady_clock::time_point;
+
+    static double seconds(Time_point from, Time_point to)
+    {
+      return std::chrono::duration<double>(to - from).count();
+    }
+
+    void finish(Time_point now)
+    {
+      struct rusage usage;
+      getrusage(RUSAGE_SELF, &usage);
+      *out_ << ", \"elapsed\": " << seconds(start_, now)
+        << ", \"peak_rss_mb\": " << double(usage.ru_maxrss) / 1024 << "}"
+        << std::endl;
+    }
+
+    std::ostream* out_;
+    Time_point start_;
+    Time_point phase_start_;
+    Time_point last_;
+};
+
+void usage(const char* program)
+{
+  std::cerr << "usage: " << program
+    << " [--incremental | --divide-and-conquer] [--spatial-sort]"
+    << " [--voronoi] [--statistics]\n"
+    << "       [--memory] [--telemetry[=file]] [--check | --check-all]\n"
+    << "       [--threads=n] [--batch=manifest]\n"
+    << "  (default)             read a triangulation in OFF format and flip\n"
+    << "                        it to the PD-Delaunay triangulation\n"
+    << "  --incremental         read a point set in OFF format (faces\n"
+    << "                        ignored) and build its PD-Delaunay\n"
+    << "                        triangulation by insertion\n"
+    << "  --divide-and-conquer  as --incremental, but build the\n"
+    << "                        triangulation by divide and conquer\n"
+    << "  --spatial-sort        renumber vertices and faces along a Hilbert\n"
+    << "                        curve before flipping (and in the output)\n"
+    << "  --voronoi             output the Voronoi diagram dual to the\n"
+    << "                        PD-Delaunay triangulation instead of the\n"
+    << "                        triangulation itself\n"
+    << "  --statistics          write the kernel statistics (predicate\n"
+    << "                        counts and, if enabled at compile time,\n"
+    << "                        latencies) as JSON to standard error\n"
+    << "  --memory              write the memory footprint of the\n"
+    << "                        triangulation (bytes per vertex, halfedge,\n"
+    << "                        and face, and the peak overheads of the\n"
+    << "                        construction and of the flips) as JSON to\n"
+    << "                        standard error\n"
+    << "  --telemetry[=file]    write progress telemetry (phases and LOP\n"
+    << "                        passes) as JSON lines to the file, or to\n"
+    << "                        standard error\n"
+    << "  --check               only test (in parallel) whether the input\n"
+    << "                        triangulation is PD-Delaunay; stop at the\n"
+    << "                        first violation, write it (if any), and\n"
+    << "                        exit with status 2 if there is one\n"
+    << "  --check-all           as --check, but find all violations\n"
+    << "  --threads=n           the number of threads used by --check,\n"
+    << "                        --divide-and-conquer, and --batch\n"
+    << "                        (default: the number of hardware threads)\n"
+    << "  --batch=manifest      process many inputs instead of standard\n"
+    << "                        input: the manifest file lists pairs of\n"
+    << "                        input and output paths (one pair per line),\n"
+    << "                        and the inputs are processed in parallel\n"
+    << "                        (cannot be combined with --memory,\n"
+    << "                        --telemetry, --check, or --check-all)\n";
 }
 
-bool is_everythig_optimal(Suspect_Map& suspects)
+// The ways in which the PD-Delaunay triangulation can be obtained.
+enum class Mode { flip, incremental, divide_and_conquer };
+
+// The kinds of PD-Delaunay checks that can be made instead.
+enum class Check { none, first_violation, all_violations };
+
+// Write the triangulation tri, or the Voronoi diagram dual to it if
+// voronoi is true, to out.
+bool write_result(const Triangulation& tri, bool voronoi, std::ostream& out)
 {
-  int x = 1;
-  
-  for( auto const& [key, val] : suspects )
+  out.precision(std::numeric_limits<double>::max_digits10);
+  if (voronoi)
   {
-      x &= val;
+    out << "Voronoi diagram:\n";
+    return output_voronoi(tri, out);
   }
-  return x == 1;
+  out << "Triangulation in OFF format:\n";
+  return tri.output_off(out);
 }
 
+// An input of a batch, and the file to which its output is written.
+struct Batch_job
+{
+  std::string input;
+  std::string output;
+};
 
-int main(int argc, char** argv)
+// Read a batch manifest from in: pairs of input and output paths,
+// separated by whitespace.
+bool read_manifest(std::istream& in, std::vector<Batch_job>& jobs)
 {
-  // lop<double>();
-  //map to tag the suspects
-  Triangulation tri(std::cin);
-  Kernel::Vector_2 u(1,0);
-  Kernel::Vector_2 v(1,1);
+  jobs.clear();
+  Batch_job job;
+  while (in >> job.input)
+  {
+    if (!(in >> job.output))
+    {
+      std::cerr << "no output path for " << job.input << "\n";
+      return false;
+    }
+    jobs.push_back(job);
+  }
+  return in.eof();
+}
+
+// Process one input of a batch, as main processes standard input.
+bool process_job(const Batch_job& job, Mode mode, bool spatial_sort,
+  bool voronoi, const Kernel::Vector_2& u, const Kernel::Vector_2& v)
+{
+  std::ifstream in(job.input);
+  if (!in)
+  {
+    return false;
+  }
+  std::vector<Kernel::Point_2> vertices;
+  std::vector<std::array<int, 3>> triangles;
+  ra::geometry::Incremental_delaunay<double> incremental(u, v);
+  ra::geometry::Divide_and_conquer_delaunay<double> divide_and_conquer(u,
+    v);
+  if ((mode == Mode::incremental &&
+    !construct(in, incremental, vertices, triangles)) ||
+    (mode == Mode::divide_and_conquer &&
+    !construct(in, divide_and_conquer, vertices, triangles)))
+  {
+    return false;
+  }
+  try
+  {
+    Triangulation tri = mode == Mode::flip ? Triangulation(in) :
+      Triangulation(vertices, triangles);
+    in.close();
+    if (spatial_sort)
+    {
+      tri.spatial_sort();
+    }
+    if (mode == Mode::flip)
+    {
+      ra::geometry::make_pd_delaunay(tri, u, v);
+    }
+    std::ofstream out(job.output);
+    return out && write_result(tri, voronoi, out) && bool(out.flush());
+  }
+  catch (const std::exception&)
+  {
+    return false;
+  }
+}
 
-  ra::geometry::Kernel<double> k;
-
-	// std::cout << "number of vertices " << tri.size_of_vertices() << '\n';
-	// std::cout << "number of faces " << tri.size_of_faces() << '\n';
-	// std::cout << "number of edges " << tri.size_of_edges() << '\n';
-	// std::cout << "number of halfedges " << tri.size_of_halfedges() << '\n';
-
-  // std::cout << "edges in triangulation:\n";
-  //all of them are suspects  
-	for (auto halfedgeIter = tri.halfedges_begin(); halfedgeIter !=
-	    tri.halfedges_end(); ++++halfedgeIter) {
-		Triangulation::Vertex_const_handle a = halfedgeIter->vertex();
-		Triangulation::Vertex_const_handle b =   
-		halfedgeIter->opposite()->vertex();
-    if(is_flippable(halfedgeIter))
-    {
-      suspects[halfedgeIter] = 0;
-    }
-	}
-  
-    // for each edge
-  while(!is_everythig_optimal(suspects))
-  {
-    for (auto halfedgeIter = tri.halfedges_begin(); halfedgeIter != tri.halfedges_end(); ++++halfedgeIter) {
-      Triangulation::Vertex_const_handle a = halfedgeIter->vertex();
-      Triangulation::Vertex_const_handle b =   
-      halfedgeIter->opposite()->vertex();
-
-
-      auto pd = halfedgeIter->opposite()->next()->vertex()->point();
-      auto pa = halfedgeIter->vertex()->point();
-      auto pc = halfedgeIter->opposite()->vertex()->point();
-      auto pb = halfedgeIter->next()->vertex()->point();
-      
-      if(k.is_locally_pd_delaunay_edge(pa,pb,pc,pd,u,v) && is_flippable(halfedgeIter)) 
+// Process the inputs of a batch with thread_count threads, each of which
+// takes the next input as soon as it is done with one; so reading, flipping
+// and writing of different inputs overlap.  The kernel statistics of all
+// the threads are accumulated in stats.  Returns the number of inputs that
+// failed (each of which is reported on standard error).
+std::size_t run_batch(const std::vector<Batch_job>& jobs, Mode mode,
+  bool spatial_sort, bool voronoi, const Kernel::Vector_2& u,
+  const Kernel::Vector_2& v, unsigned thread_count,
+  ra::geometry::Kernel<double>::Statistics& stats)
+{
+  using Predicates = ra::geometry::Kernel<double>;
+  std::atomic<std::size_t> next_job(0);
+  std::size_t failed = 0;
+  std::mutex mutex;
+  stats = Predicates::Statistics();
+  const auto work = [&] {
+    Predicates::clear_statistics();
+    for (std::size_t i = next_job++; i < jobs.size(); i = next_job++)
+    {
+      if (!process_job(jobs[i], mode, spatial_sort, voronoi, u, v))
       {
-        // std::cout << "faces in You are inside:\n";
-        
-          // tri.flip_edge(halfedgeIter);
-          suspects[halfedgeIter] = 1;
-          suspects[halfedgeIter->opposite()] = 1;
-          // mark_potential_suspects(tri,halfedgeIter);
+        std::lock_guard<std::mutex> lock(mutex);
+        std::cerr << jobs[i].input << ": failed\n";
+        ++failed;
       }
-      else if(is_flippable(halfedgeIter))
+    }
+    Predicates::Statistics thread_stats;
+    Predicates::get_statistics(thread_stats);
+    std::lock_guard<std::mutex> lock(mutex);
+    Predicates::accumulate_statistics(stats, thread_stats);
+  };
+
+  thread_count = unsigned(std::max<std::size_t>(1, std::min<std::size_t>(
+    thread_count, jobs.size())));
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < thread_count; ++i)
+  {
+    threads.emplace_back(work);
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  return failed;
+}
+
+int main(int argc, char** argv)
+{
+  Mode mode = Mode::flip;
+  bool spatial_sort = false;
+  bool voronoi = false;
+  bool statistics = false;
+  bool memory = false;
+  Check check = Check::none;
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  std::ofstream telemetry_file;
+  std::ostream* telemetry_out = nullptr;
+  std::string manifest;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg(argv[i]);
+    if (arg == "--incremental" && mode == Mode::flip)
+    {
+      mode = Mode::incremental;
+    }
+    else if (arg == "--divide-and-conquer" && mode == Mode::flip)
+    {
+      mode = Mode::divide_and_conquer;
+    }
+    else if (arg == "--spatial-sort")
+    {
+      spatial_sort = true;
+    }
+    else if (arg == "--voronoi")
+    {
+      voronoi = true;
+    }
+    else if (arg == "--statistics")
+    {
+      statistics = true;
+    }
+    else if (arg == "--memory")
+    {
+      memory = true;
+    }
+    else if (arg == "--telemetry")
+    {
+      telemetry_out = &std::cerr;
+    }
+    else if (arg.compare(0, 12, "--telemetry=") == 0)
+    {
+      telemetry_file.open(arg.substr(12));
+      if (!telemetry_file)
       {
-          tri.flip_edge(halfedgeIter);
-          suspects[halfedgeIter] = 1;
-          suspects[halfedgeIter->opposite()] = 1;
-          mark_potential_suspects(tri,halfedgeIter);
-                            
+        std::cerr << "cannot open " << arg.substr(12) << "\n";
+        return 1;
       }
+      telemetry_out = &telemetry_file;
+    }
+    else if (arg == "--check" && check == Check::none)
+    {
+      check = Check::first_violation;
+    }
+    else if (arg == "--check-all" && check == Check::none)
+    {
+      check = Check::all_violations;
+    }
+    else if (arg.compare(0, 8, "--batch=") == 0 && arg.size() > 8)
+    {
+      manifest = arg.substr(8);
+    }
+    else if (arg.compare(0, 10, "--threads=") == 0 &&
+      std::atoi(arg.c_str() + 10) > 0)
+    {
+      threads = unsigned(std::atoi(arg.c_str() + 10));
+    }
+    else
+    {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if (!manifest.empty() && (memory || telemetry_out ||
+    check != Check::none))
+  {
+    usage(argv[0]);
+    return 1;
+  }
+
+  Telemetry telemetry(telemetry_out);
+  Kernel::Vector_2 u(1,0);
+  Kernel::Vector_2 v(1,1);
+
+  if (!manifest.empty())
+  {
+    std::ifstream manifest_file(manifest);
+    std::vector<Batch_job> jobs;
+    if (!manifest_file || !read_manifest(manifest_file, jobs))
+    {
+      std::cerr << "cannot read " << manifest << "\n";
+      return 1;
+    }
+    ra::geometry::Kernel<double>::Statistics stats;
+    const std::size_t failed = run_batch(jobs, mode, spatial_sort, voronoi,
+      u, v, threads, stats);
+    if (statistics)
+    {
+      ra::geometry::Kernel<double>::write_statistics_json(stats, std::cerr);
+    }
+    return failed == 0 ? 0 : 1;
+  }
+
+  // In construction modes, the triangulation is built from the points and
+  // handed to Triangulation_2 in memory.
+  std::vector<Kernel::Point_2> vertices;
+  std::vector<std::array<int, 3>> triangles;
+  ra::geometry::Incremental_delaunay<double> incremental(u, v);
+  ra::geometry::Divide_and_conquer_delaunay<double> divide_and_conquer(u, v,
+    threads);
+  if (mode == Mode::incremental &&
+    !construct(std::cin, incremental, vertices, triangles))
+  {
+    return 1;
+  }
+  if (mode == Mode::divide_and_conquer &&
+    !construct(std::cin, divide_and_conquer, vertices, triangles))
+  {
+    return 1;
+  }
+  if (mode != Mode::flip)
+  {
+    telemetry.phase("construct");
+  }
+  Triangulation tri = mode == Mode::flip ? Triangulation(std::cin) :
+    Triangulation(vertices, triangles);
+  vertices = std::vector<Kernel::Point_2>();
+  triangles = std::vector<std::array<int, 3>>();
+  telemetry.phase("read");
+  if (spatial_sort)
+  {
+    tri.spatial_sort();
+    telemetry.phase("spatial_sort");
+  }
+
+	std::cout.precision(std::numeric_limits<double>::max_digits10);
+  if (check != Check::none)
+  {
+    if (memory)
+    {
+      write_memory_footprint_json(tri, 0, std::cerr);
     }
-  } 
-  
-	// Output the triangulation in OFF format to standard output.
-	std::cout << "Triangulation in OFF format:\n";
-	tri.output_off(std::cout);
-  return 0;
+    const auto result = ra::geometry::check_pd_delaunay(tri, u, v, threads,
+      check == Check::all_violations);
+    telemetry.phase("check");
+    // Write each violating edge as the coordinates of its endpoints.
+    std::cout << (result.violations.empty() ? "PD-Delaunay\n" :
+      "Not PD-Delaunay:\n");
+    for (auto h : result.violations)
+    {
+      const auto& c = h->opposite()->vertex()->point();
+      const auto& a = h->vertex()->point();
+      std::cout << c.x() << " " << c.y() << " " << a.x() << " " << a.y()
+        << "\n";
+    }
+    if (statistics)
+    {
+      ra::geometry::Kernel<double>::write_statistics_json(result.statistics,
+        std::cerr);
+    }
+    return result.violations.empty() ? 0 : 2;
+  }
+
+  // A constructed triangulation is PD-Delaunay already.
+  std::size_t lop_bytes = 0;
+  if (mode == Mode::flip)
+  {
+    lop_bytes = ra::geometry::make_pd_delaunay(tri, u, v,
+      [&telemetry](const ra::geometry::Lop_pass& pass) {
+      telemetry.pass(pass);
+    }).suspect_bytes;
+    telemetry.phase("flip");
+  }
+  if (memory)
+  {
+    write_memory_footprint_json(tri, lop_bytes, std::cerr);
+  }
+
+  const bool ok = write_result(tri, voronoi, std::cout);
+  telemetry.phase("output");
+
+  if (statistics)
+  {
+    ra::geometry::Kernel<double>::Statistics stats;
+    ra::geometry::Kernel<double>::get_statistics(stats);
+    ra::geometry::Kernel<double>::accumulate_statistics(stats,
+      divide_and_conquer.worker_statistics());
+    ra::geometry::Kernel<double>::write_statistics_json(stats, std::cerr);
+  }
+  return ok ? 0 : 1;
 }
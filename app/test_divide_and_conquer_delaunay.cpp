@@ -0,0 +1,184 @@
+#include "test_fixtures.hpp"
+#include "ra/divide_and_conquer_delaunay.hpp"
+#include "ra/incremental_delaunay.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace fixtures;
+using namespace ra::geometry;
+using namespace std;
+
+using Triangle = array<int, 3>;
+
+using Coordinates = pair<double, double>;
+
+// Get the triangles as triples of points (which do not depend on the copy
+// of a duplicate point that is kept), each rotated to start at its
+// smallest point, in sorted order.
+vector<array<Coordinates, 3>> normalized(const vector<Point>& vertices,
+  const vector<Triangle>& triangles)
+{
+  vector<array<Coordinates, 3>> result;
+  for (const Triangle& t : triangles)
+  {
+    array<Coordinates, 3> triple;
+    for (int i = 0; i < 3; ++i)
+    {
+      triple[i] = {vertices[t[i]].x(), vertices[t[i]].y()};
+    }
+    rotate(triple.begin(), min_element(triple.begin(), triple.end()),
+      triple.end());
+    result.push_back(triple);
+  }
+  sort(result.begin(), result.end());
+  return result;
+}
+
+// Check that divide and conquer with thread_count threads gives the same
+// triangulation as incremental insertion.
+void check(const vector<Point>& points, unsigned thread_count)
+{
+  Incremental_delaunay<double> incremental(u, v);
+  vector<Point> expected_vertices;
+  vector<Triangle> expected_triangles;
+  const bool expected = incremental.triangulate(points, expected_vertices,
+    expected_triangles);
+
+  Divide_and_conquer_delaunay<double> delaunay(u, v, thread_count);
+  vector<Point> vertices;
+  vector<Triangle> triangles;
+  assert(delaunay.triangulate(points, vertices, triangles) == expected);
+  if (expected)
+  {
+    assert(vertices.size() == expected_vertices.size());
+    assert(normalized(vertices, triangles) ==
+      normalized(expected_vertices, expected_triangles));
+  }
+  // Large inputs are split between the threads.
+  if (thread_count > 1 && points.size() >= 20000)
+  {
+    assert(delaunay.worker_statistics().orientation_total_count > 0);
+  }
+}
+
+void check(const vector<Point>& points)
+{
+  for (unsigned thread_count : {1u, 2u, 3u, 8u})
+  {
+    check(points, thread_count);
+  }
+}
+
+vector<Point> random_points(int n, unsigned seed)
+{
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<double> coordinate(0, 1);
+  vector<Point> points;
+  for (int i = 0; i < n; ++i)
+  {
+    points.emplace_back(coordinate(generator), coordinate(generator));
+  }
+  return points;
+}
+
+vector<Point> grid_points(int n)
+{
+  vector<Point> points;
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      points.emplace_back(i, j);
+    }
+  }
+  return points;
+}
+
+void test_random()
+{
+  cout << "Testing random points" << endl;
+  for (int n : {3, 4, 5, 10, 100, 1000})
+  {
+    check(random_points(n, n));
+  }
+  // Enough points for the halves to run in parallel.
+  check(random_points(20000, 1), 4);
+}
+
+void test_grid()
+{
+  cout << "Testing grids" << endl;
+  for (int n : {2, 3, 4, 10})
+  {
+    check(grid_points(n));
+  }
+  check(grid_points(130), 4);
+}
+
+void test_cocircular()
+{
+  cout << "Testing cocircular points" << endl;
+  // The vertices of a regular octagon (with exact coordinates) and its
+  // center.
+  vector<Point> points{{3, 0}, {0, 3}, {-3, 0}, {0, -3}, {2, 2}, {-2, 2},
+    {-2, -2}, {2, -2}};
+  // Not exactly on the circle, but near it.
+  check(points);
+  points = {{5, 0}, {0, 5}, {-5, 0}, {0, -5}, {3, 4}, {-3, 4}, {-4, -3},
+    {4, -3}, {4, 3}, {-4, 3}, {-3, -4}, {3, -4}};
+  check(points);
+  points.emplace_back(0, 0);
+  check(points);
+}
+
+void test_collinear()
+{
+  cout << "Testing collinear points" << endl;
+  vector<Point> points;
+  check(points);
+  points.emplace_back(0, 0);
+  check(points);
+  points.emplace_back(1, 1);
+  check(points);
+  for (int i = 2; i < 100; ++i)
+  {
+    points.emplace_back(i, i);
+  }
+  check(points);
+  // One point off the line.
+  points.emplace_back(0, 1);
+  check(points);
+}
+
+void test_duplicates()
+{
+  cout << "Testing duplicate points" << endl;
+  vector<Point> points = random_points(500, 7);
+  const vector<Point> copy = points;
+  points.insert(points.end(), copy.begin(), copy.begin() + 200);
+  std::mt19937 generator(8);
+  shuffle(points.begin(), points.end(), generator);
+  check(points);
+  check({{0, 0}, {0, 0}, {1, 0}, {1, 0}, {0, 1}});
+  check({{0, 0}, {0, 0}, {1, 1}});
+  // Duplicates on both sides of a parallel split.
+  points = grid_points(130);
+  points.insert(points.end(), points.begin(), points.begin() + 5000);
+  check(points, 4);
+}
+
+int main()
+{
+  test_random();
+  test_grid();
+  test_cocircular();
+  test_collinear();
+  test_duplicates();
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
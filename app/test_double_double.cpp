@@ -0,0 +1,106 @@
+#include "ra/double_double.hpp"
+#include <cassert>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+using namespace ra::math;
+using namespace std;
+
+void constructor_tests()
+{
+  cout << "Testing constructors" << endl;
+
+  double_double a1(1.5);
+  assert(a1.hi() == 1.5 && a1.lo() == 0 && a1.radius() == 0);
+
+  double_double a2(a1);
+  assert(a2.hi() == 1.5);
+
+  double_double a3(std::move(a2));
+  assert(a3.hi() == 1.5 && a3.radius() == 0);
+
+  double_double a4;
+  assert(a4.hi() == 0 && a4.sign() == 0);
+}
+
+void arithmetic()
+{
+  cout << "Testing arithmetic" << endl;
+
+  //the rounding error of a double sum is kept in the low part
+  const double big = 1 / std::numeric_limits<double>::epsilon();
+  double_double a = double_double(big) + double_double(0.5);
+  assert(a.hi() == big && a.lo() == 0.5);
+  assert(a.radius() > 0 && a.radius() < 1e-10);
+
+  //the rounding error of a double product is kept in the low part
+  const double x = 1 + std::numeric_limits<double>::epsilon();
+  double_double b = double_double(x) * double_double(x);
+  assert(b.hi() + b.lo() == b.hi());
+  assert(b.lo() == std::numeric_limits<double>::epsilon() *
+    std::numeric_limits<double>::epsilon());
+
+  double_double c = double_double(2) - double_double(3);
+  assert(c.hi() == -1 && c.sign() == -1);
+
+  //operating on itself
+  double_double d(3);
+  d *= d;
+  d -= d;
+  assert(d.hi() == 0 && d.radius() > 0);
+}
+
+void sign()
+{
+  cout << "Testing sign" << endl;
+
+  double_double::statistics stats;
+  double_double::clear_statistics();
+
+  //(1 + 2^-30)^2 - 1 - 2^-29 = 2^-60, which double arithmetic loses
+  const double_double x(1 + std::ldexp(1.0, -30));
+  const double_double r = x * x - double_double(1) -
+    double_double(std::ldexp(1.0, -29));
+  assert(r.hi() == std::ldexp(1.0, -60));
+  assert(r.sign() == 1);
+  assert((-r).sign() == -1);
+
+  //an exact zero with a nonzero radius cannot be decided
+  const double_double z = x * x - x * x;
+  bool thrown = false;
+  try
+  {
+    z.sign();
+  }
+  catch(indeterminate_result& e)
+  {
+    thrown = true;
+  }
+  assert(thrown);
+  double_double::get_statistics(stats);
+  assert(stats.indeterminate_result_count == 1);
+  assert(stats.arithmetic_op_count > 0);
+
+  //an overflow cannot be decided either
+  const double_double huge(std::numeric_limits<double>::max());
+  thrown = false;
+  try
+  {
+    (huge * huge - huge * huge).sign();
+  }
+  catch(indeterminate_result& e)
+  {
+    thrown = true;
+  }
+  assert(thrown);
+}
+
+int main()
+{
+  constructor_tests();
+  arithmetic();
+  sign();
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
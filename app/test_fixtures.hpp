@@ -0,0 +1,62 @@
+#ifndef test_fixtures_hpp
+#define test_fixtures_hpp
+
+#include "triangulation_2.hpp"
+#include "ra/incremental_delaunay.hpp"
+#include <CGAL/Cartesian.h>
+#include <array>
+#include <cassert>
+#include <vector>
+
+// The triangulations shared by the tests of the algorithms on
+// Triangulation_2.
+namespace fixtures {
+
+using K = CGAL::Cartesian<double>;
+using Triangulation = trilib::Triangulation_2<K>;
+using Point = K::Point_2;
+
+// The first and second preferred directions.
+const K::Vector_2 u(1, 0);
+const K::Vector_2 v(1, 1);
+
+// Make the PD-Delaunay triangulation of the points.
+inline Triangulation make_delaunay(const std::vector<Point>& points)
+{
+  ra::geometry::Incremental_delaunay<double> delaunay(u, v);
+  std::vector<Point> vertices;
+  std::vector<std::array<int, 3>> triangles;
+  const bool ok = delaunay.triangulate(points, vertices, triangles);
+  assert(ok);
+  static_cast<void>(ok);
+  return Triangulation(vertices, triangles);
+}
+
+// Make a triangulation of the points of an n by n grid (which has many
+// collinear points), with each cell split along its diagonal.
+inline Triangulation make_grid(int n)
+{
+  std::vector<Point> points;
+  for (int i = 0; i < n; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      points.emplace_back(i, j);
+    }
+  }
+  std::vector<std::array<int, 3>> faces;
+  for (int i = 0; i + 1 < n; ++i)
+  {
+    for (int j = 0; j + 1 < n; ++j)
+    {
+      const int a = i * n + j;
+      faces.push_back({a, a + n, a + n + 1});
+      faces.push_back({a, a + n + 1, a + 1});
+    }
+  }
+  return Triangulation(points, faces);
+}
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #include "ra/interval.hpp"
 #include <string.h>
 #include <cassert>
+#include <sstream>
 
 using namespace ra::math;
 using namespace std;
@@ -146,6 +147,41 @@ void multiply()
   assert(z2.upper() == T(4));  
 }
 
+template <class T>
+void divide()
+{
+  interval<T> a1(-1.0, 7.0);
+  interval<T> a2(2.0, 4.0);
+
+  a1 /= a2;
+  assert(a1.lower() == T(-0.5));
+  assert(a1.upper() == T(3.5));
+
+  //divided by itself
+  interval<T> self(2.0, 4.0);
+  self /= self;
+  assert(self.lower() == T(0.5));
+  assert(self.upper() == T(2.0));
+
+  //the quotient is not representable
+  interval<T> third(1);
+  third /= interval<T>(3);
+  assert(third.lower() < third.upper());
+  assert(third.lower() <= T(1) / T(3) && T(1) / T(3) <= third.upper());
+
+  //divided by an interval containing zero
+  interval<T> z1(-1, 1);
+  try
+  {
+    a2 /= z1;
+    assert(false);
+  } catch (ra::math::indeterminate_result& e)
+  {
+  }
+  assert(a2.lower() == T(2.0));
+  assert(a2.upper() == T(4.0));
+}
+
 
 template <class T>
 void compound_operators()
@@ -156,6 +192,8 @@ void compound_operators()
   deduct<T>();
   cout << "Doing multiplication" << endl;
   multiply<T>();
+  cout << "Doing division" << endl;
+  divide<T>();
   cout << "Done compound operators" << endl << endl;
 }
 
@@ -312,6 +350,35 @@ void binary_multiply()
   assert(z2.upper() == T(-1));  
 }
 
+template <class T>
+void binary_divide()
+{
+  interval<T> a1(-1.0, 7.0);
+  interval<T> a2(2.0, 4.0);
+
+  auto r1 = a1 / a2;
+  assert(r1.lower() == T(-0.5));
+  assert(r1.upper() == T(3.5));
+  assert(a1.lower() == T(-1.0));
+  assert(a1.upper() == T(7.0));
+  assert(a2.lower() == T(2.0));
+  assert(a2.upper() == T(4.0));
+
+  interval<T> n1(-4, -2);
+  auto r2 = reciprocal(n1);
+  assert(r2.lower() == T(-0.5));
+  assert(r2.upper() == T(-0.25));
+
+  interval<T> z1(0, 1);
+  try
+  {
+    reciprocal(z1);
+    assert(false);
+  } catch (ra::math::indeterminate_result& e)
+  {
+  }
+}
+
 template <class T>
 void binary_operators()
 {
@@ -321,9 +388,94 @@ void binary_operators()
   binary_deduct<T>();
   cout << "Doing binary multiplication" << endl;
   binary_multiply<T>();
+  cout << "Doing binary division" << endl;
+  binary_divide<T>();
   cout << "Done binary operators" << endl << endl;
 }
 
+template <class T>
+void expressions()
+{
+  cout << "Doing expressions" << endl;
+
+  // Operands whose bounds are not exact, so that every operation rounds.
+  interval<T> a(T(1) / T(3), T(2) / T(3));
+  interval<T> b(T(-7) / T(10), T(1) / T(10));
+  interval<T> c(T(-5) / T(7), T(-2) / T(7));
+  interval<T> d(T(3) / T(10), T(9) / T(10));
+
+  //the same bounds as the operations done one by one (or tighter ones,
+  //with fused multiply-adds)
+  const interval<T> fused = a*(b*c - d*d) - (c - a)*(b + d) + a*a;
+  interval<T> ad = b * c;
+  interval<T> dd = d * d;
+  interval<T> first = a * (ad - dd);
+  interval<T> ca = c - a;
+  interval<T> bd = b + d;
+  interval<T> second = ca * bd;
+  interval<T> aa = a * a;
+  interval<T> difference = first - second;
+  const interval<T> stepwise = difference + aa;
+#if defined(RA_INTERVAL_FMA)
+  assert(stepwise.lower() <= fused.lower());
+  assert(fused.upper() <= stepwise.upper());
+#else
+  assert(fused.lower() == stepwise.lower());
+  assert(fused.upper() == stepwise.upper());
+#endif
+  assert(fused.lower() < fused.upper());
+
+  //the product of a fused multiply-add is exact
+  interval<T> third(T(1) / T(3));
+  interval<T> three(3);
+  interval<T> one(1);
+  const interval<T> residual = third * three - one;
+#if defined(RA_INTERVAL_FMA)
+  assert(residual.is_singleton());
+  assert(residual.lower() == std::fma(third.lower(), T(3), T(-1)));
+#else
+  assert(!residual.is_singleton());
+#endif
+
+  //a single change of the rounding mode (and its restore) per expression
+  typename interval<T>::statistics stats;
+  interval<T>::clear_statistics();
+  const interval<T> det = a*(b*c - d*a) - b*(c*c - d*b) + c*(c*a - b*b);
+  interval<T>::get_statistics(stats);
+  assert(stats.arithmetic_op_count == 14);
+  assert(stats.rounding_mode_change_count == 2);
+
+  //no change of the rounding mode within upward_rounding
+  {
+    upward_rounding rounding;
+    assert(std::fegetround() == FE_UPWARD);
+    interval<T>::clear_statistics();
+    const interval<T> same = a*(b*c - d*a) - b*(c*c - d*b) +
+      c*(c*a - b*b);
+    interval<T>::get_statistics(stats);
+    assert(stats.rounding_mode_change_count == 0);
+    assert(same.lower() == det.lower() && same.upper() == det.upper());
+  }
+  assert(std::fegetround() == FE_TONEAREST);
+
+  //the accessors and division evaluate the expression
+  assert((a - a).lower() == a.lower() - a.upper());
+  assert((a * d).sign() == 1);
+  assert(!(a + b).is_singleton());
+  const interval<T> quotient = (b + b) / (d * d);
+  assert(quotient.lower() < 0 && quotient.upper() > 0);
+
+  //the operands are copied, so an expression may outlive temporaries, and
+  //does not see later changes to its operands
+  const auto sum = interval<T>(1, 2) + interval<T>(3, 4);
+  interval<T> x(1, 2);
+  const auto twice = x + x;
+  x = interval<T>(5, 6);
+  assert(sum.lower() == T(4) && sum.upper() == T(6));
+  assert(twice.lower() == T(2) && twice.upper() == T(4));
+  cout << "Done expressions" << endl << endl;
+}
+
 template <class T>
 void less_than()
 {
@@ -370,6 +522,40 @@ void stream_inserter()
   cout << endl << "Done streamline inserter" << endl << endl;
 }
 
+// Interval expressions are compared and streamed like intervals.
+template <class T>
+void unevaluated_expressions()
+{
+  cout << "Doing unevaluated expressions" << endl;
+
+  interval<T> a(1.0, 2.0);
+  interval<T> b(3.0, 4.0);
+  interval<T> c(20.0, 30.0);
+  assert(a + b < c);
+  assert(a < c - b);
+  assert((a * b) < c);
+  assert(!(c < a * b));
+  assert(a * b - a < c * a);
+  assert(!(a + b < b));
+  try
+  {
+    (void)(a + b < interval<T>(5.0, 7.0));
+    assert(false);
+  } catch (ra::math::indeterminate_result& e)
+  {
+  }
+
+  ostringstream expression;
+  expression << a + b;
+  ostringstream sum;
+  sum << interval<T>(a + b);
+  assert(expression.str() == sum.str());
+  assert(expression.str() == "[" + to_string(T(4)) + "," + to_string(T(6)) +
+    "]");
+  cout << a * b - c << endl;
+  cout << "Done unevaluated expressions" << endl << endl;
+}
+
 template <class T> void do_test()
 {
     constructor_tests<T>();
@@ -377,8 +563,10 @@ template <class T> void do_test()
     check_singleton<T>();
     check_sign<T>();
     binary_operators<T>();
+    expressions<T>();
     less_than<T>();
     stream_inserter<T>();
+    unevaluated_expressions<T>();
 }
 
 int main()
@@ -1,6 +1,9 @@
 #include "ra/kernel.hpp"
 #include <CGAL/MP_Float.h>
 #include <CGAL/Cartesian.h>
+#include <cmath>
+#include <random>
+#include <sstream>
 
 using namespace ra::geometry;
 using namespace std;
@@ -103,6 +106,16 @@ void test_local_pd_dl()
   assert(dl.is_locally_pd_delaunay_edge(a, b, c, d, u, v) == false);
   assert(dl.is_locally_pd_delaunay_edge(c, a, b, e, u, v) == false);
   assert(dl.is_locally_pd_delaunay_edge(a, b, c, f, u, v));
+
+  //cocircular quad whose opposite sides are not parallel
+  auto p = generate_points<T>(5, 0);
+  auto q = generate_points<T>(0, 5);
+  auto r = generate_points<T>(-5, 0);
+  auto s = generate_points<T>(3, -4);
+  auto x = generate_vectors<T>(1, 0);
+  auto y = generate_vectors<T>(1, 1);
+  assert(dl.is_locally_pd_delaunay_edge(p, q, r, s, x, y));
+  assert(dl.is_locally_pd_delaunay_edge(q, r, s, p, x, y) == false);
 }
 
 template <class T>
@@ -139,6 +152,176 @@ void test_side_of_circle()
   assert(circle.side_of_oriented_circle(a, b, c, f) == Kernel<T>::Oriented_side::on_negative_side);
 }
 
+template <class T>
+void test_circumcenter()
+{
+  cout << "Testing circumcenter" << endl;
+  Kernel<T> k;
+  auto a = generate_points<T>(0, 0);
+  auto b = generate_points<T>(2, 0);
+  auto c = generate_points<T>(0, 2);
+  auto d = generate_points<T>(3, 0);
+  auto e = generate_points<T>(1, 3);
+
+  //the center is computed exactly
+  auto r1 = k.circumcenter(a, b, c);
+  assert(r1.point.x() == T(1) && r1.point.y() == T(1));
+  assert(r1.x_error == T(0) && r1.y_error == T(0));
+
+  //the center (3/2, 7/6) is not representable
+  auto r2 = k.circumcenter(a, d, e);
+  assert(r2.point.x() == T(1.5) && r2.x_error == T(0));
+  assert(r2.y_error > T(0) && r2.y_error < T(1e-5));
+  assert(6 * ((long double)r2.point.y() - r2.y_error) <= 7);
+  assert(6 * ((long double)r2.point.y() + r2.y_error) >= 7);
+}
+
+template <class T>
+void test_statistics()
+{
+  cout << "Testing statistics" << endl;
+  Kernel<T> k;
+  typename Kernel<T>::Statistics stats;
+  auto a = generate_points<T>(0, 0);
+  auto b = generate_points<T>(1, 1);
+  auto c = generate_points<T>(T(0.1), T(0.1));
+  auto d = generate_points<T>(0, 1);
+
+  Kernel<T>::clear_statistics();
+  Kernel<T>::get_statistics(stats);
+  assert(stats.orientation_total_count == 0);
+  assert(stats.rounding_mode_change_count == 0);
+  assert(stats.exception_count == 0);
+
+  //one test with integer coordinates, and one that throws in the interval and
+  //double-double stages (c is on the line ab, but neither computation is
+  //exact) and needs exact arithmetic
+  k.orientation(a, b, d);
+  k.orientation(a, b, c);
+  Kernel<T>::get_statistics(stats);
+  assert(stats.orientation_total_count == 2);
+  assert(stats.orientation_integer_count == 1);
+  assert(stats.orientation_double_double_count == 1);
+  assert(stats.orientation_exact_count == 1);
+  assert(stats.rounding_mode_change_count > 0);
+  assert(stats.exception_count == 2);
+
+  //e is one ulp above the line ab, which only the interval stage misses
+  auto e = generate_points<T>(T(0.1), std::nextafter(T(0.1), T(1)));
+  assert(k.orientation(a, b, e) == Kernel<T>::Orientation::left_turn);
+  Kernel<T>::get_statistics(stats);
+  assert(stats.orientation_double_double_count == 2);
+  assert(stats.orientation_exact_count == 1);
+#ifdef RA_KERNEL_PROFILING
+  assert(stats.orientation_latencies.integer_stage.count() == 1);
+  assert(stats.orientation_latencies.interval_stage.count() == 2);
+  assert(stats.orientation_latencies.double_double_stage.count() == 2);
+  assert(stats.orientation_latencies.exact_stage.count() == 1);
+  assert(stats.side_of_oriented_circle_latencies.interval_stage.count() == 0);
+#endif
+
+  std::ostringstream json;
+  Kernel<T>::write_statistics_json(stats, json);
+  assert(json.str().find(
+    "\"orientation\": {\"total\": 3, \"integer\": 1, \"double_double\": 2, "
+    "\"exact\": 1") !=
+    std::string::npos);
+  assert(json.str().find("\"exceptions\": 3") != std::string::npos);
+}
+
+template <class T>
+void test_integer_stage()
+{
+  cout << "Testing integer stage" << endl;
+  Kernel<T> k;
+  typename Kernel<T>::Statistics stats;
+  using Point = typename Kernel<T>::Point;
+  using Vector = typename Kernel<T>::Vector;
+  std::mt19937 random(1);
+
+  //the integer stage must agree with the filtered stages, which are used
+  //for the same points moved by one half
+  const auto moved = [](const Point& p) {
+    return Point(p.x() + T(0.5), p.y() + T(0.5));
+  };
+  for (int range : {4, 1 << 20, (1 << 26) - 1})
+  {
+    std::uniform_int_distribution<int> coordinate(-range, range);
+    std::uniform_int_distribution<int> small(-2, 2);
+    for (int i = 0; i < 1000; ++i)
+    {
+      Point p[4];
+      for (auto& q : p)
+      {
+        q = Point(T(coordinate(random)), T(coordinate(random)));
+      }
+      //make many tests degenerate
+      if (i % 2 == 0)
+      {
+        p[2] = Point(2 * p[1].x() - p[0].x(), 2 * p[1].y() - p[0].y());
+        p[3] = Point(p[0].x() + p[1].y() - p[0].y() + small(random),
+          p[0].y() - p[1].x() + p[0].x());
+      }
+      if (std::abs(p[2].x()) >= T(1 << 26) || std::abs(p[2].y()) >= T(1 << 26) ||
+        std::abs(p[3].x()) >= T(1 << 26) || std::abs(p[3].y()) >= T(1 << 26))
+      {
+        continue;
+      }
+      const Vector v(1, 1);
+      Kernel<T>::clear_statistics();
+      const auto o = k.orientation(p[0], p[1], p[2]);
+      const auto s = k.side_of_oriented_circle(p[0], p[1], p[2], p[3]);
+      const auto d = k.preferred_direction(p[0], p[1], p[2], p[3], v);
+      Kernel<T>::get_statistics(stats);
+      assert(stats.orientation_integer_count == 1);
+      assert(stats.side_of_oriented_circle_integer_count == 1);
+      assert(stats.preferred_direction_integer_count == 1);
+      assert(stats.exception_count == 0);
+      assert(k.orientation(moved(p[0]), moved(p[1]), moved(p[2])) == o);
+      assert(k.side_of_oriented_circle(moved(p[0]), moved(p[1]),
+        moved(p[2]), moved(p[3])) == s);
+      assert(k.preferred_direction(moved(p[0]), moved(p[1]), moved(p[2]),
+        moved(p[3]), v) == d);
+      Kernel<T>::get_statistics(stats);
+      assert(stats.orientation_integer_count == 1);
+    }
+  }
+
+  //too large for the integer stage
+  Kernel<T>::clear_statistics();
+  k.orientation(Point(0, 0), Point(T(1 << 26), 0), Point(0, 1));
+  Kernel<T>::get_statistics(stats);
+  assert(stats.orientation_integer_count == 0);
+}
+
+void test_latency_histogram()
+{
+  cout << "Testing latency histogram" << endl;
+  latency_histogram h;
+  assert(h.count() == 0 && h.quantile(0.5) == 0);
+
+  //small values are exact
+  for (std::uint64_t i = 1; i <= 8; ++i)
+  {
+    h.record(i);
+  }
+  assert(h.count() == 8 && h.sum() == 36 && h.max() == 8);
+  assert(h.quantile(0.5) == 4);
+  assert(h.quantile(1) == 8);
+
+  //large values are within the relative error
+  h.clear();
+  for (int i = 0; i < 99; ++i)
+  {
+    h.record(100);
+  }
+  h.record(1000000);
+  assert(h.quantile(0.5) >= 100 && h.quantile(0.5) < 100 + 100 / 8);
+  assert(h.quantile(0.99) == h.quantile(0.5));
+  assert(h.quantile(0.999) == 1000000);
+  assert(h.max() == 1000000);
+}
+
 template <class T>
 void do_test()
 {
@@ -149,11 +332,15 @@ void do_test()
     test_strictly_convex<T>();
     test_local_dl<T>();
     test_local_pd_dl<T>();
+    test_circumcenter<T>();
+    test_statistics<T>();
   
 }
 
 int main()
 {
     do_test<float>();
+    test_integer_stage<double>();
+    test_latency_histogram();
     return 0;
 }
@@ -0,0 +1,166 @@
+#include "ra/lazy_exact.hpp"
+#include "ra/kernel.hpp"
+#include <CGAL/MP_Float.h>
+#include <CGAL/Cartesian.h>
+#include <cassert>
+#include <iostream>
+#include <limits>
+
+using namespace ra::math;
+using namespace ra::geometry;
+using namespace std;
+
+template <class T>
+void constructor_tests()
+{
+  cout << "Testing constructors" << endl;
+
+  lazy_exact<T> a1(T(1.5));
+  assert(a1.approx().lower() == T(1.5));
+  assert(a1.approx().upper() == T(1.5));
+
+  lazy_exact<T> a2(a1);
+  assert(a2.approx().lower() == T(1.5));
+
+  lazy_exact<T> a3(std::move(a2));
+  assert(a3.approx().upper() == T(1.5));
+  assert(a3.exact() == CGAL::MP_Float(T(1.5)));
+}
+
+template <class T>
+void arithmetic()
+{
+  cout << "Testing arithmetic" << endl;
+
+  lazy_exact<T> a(T(2));
+  lazy_exact<T> b(T(3));
+  auto c = a * b - (a + b);
+  assert(c.approx().lower() == T(1));
+  assert(c.approx().upper() == T(1));
+  assert(c.exact() == CGAL::MP_Float(1));
+
+  //operating on itself
+  lazy_exact<T> d(T(3));
+  d *= d;
+  d -= d;
+  assert(d.sign() == 0);
+}
+
+template <class T>
+void sign()
+{
+  cout << "Testing sign" << endl;
+
+  typename lazy_exact<T>::statistics stats;
+
+  //decided by the interval approximation
+  lazy_exact<T>::clear_statistics();
+  lazy_exact<T> a(T(0.1));
+  auto b = a * lazy_exact<T>(T(3)) + lazy_exact<T>(T(1));
+  assert(b.sign() == 1);
+  lazy_exact<T>::get_statistics(stats);
+  assert(stats.exact_evaluation_count == 0);
+
+  //zero, which needs exact evaluation
+  auto c = a * lazy_exact<T>(T(3)) - (a + a + a);
+  assert(c.approx().lower() < c.approx().upper());
+  assert(c.sign() == 0);
+  lazy_exact<T>::get_statistics(stats);
+  assert(stats.exact_evaluation_count > 0);
+
+  //the exact value is cached
+  const auto count = stats.exact_evaluation_count;
+  assert(c.sign() == 0);
+  lazy_exact<T>::get_statistics(stats);
+  assert(stats.exact_evaluation_count == count);
+
+  //tiny but not zero
+  const T big = T(2) / std::numeric_limits<T>::epsilon();
+  auto d = (lazy_exact<T>(big) + lazy_exact<T>(T(1))) - lazy_exact<T>(big);
+  assert(d.approx().lower() <= T(0));
+  assert(d.sign() == 1);
+}
+
+template <class T>
+void deep_expressions()
+{
+  cout << "Testing deep expressions" << endl;
+
+  //a sum of n terms is a DAG n levels deep, which is evaluated and
+  //released without recursion
+  const int n = 1000000;
+  const lazy_exact<T> tenth(T(0.1));
+  lazy_exact<T> sum;
+  for (int i = 0; i < n; ++i)
+  {
+    sum += tenth;
+  }
+  const auto difference = sum - tenth * lazy_exact<T>(T(n));
+  assert(difference.sign() == 0);
+  assert(sum.exact() == (tenth * lazy_exact<T>(T(n))).exact());
+
+  //released without being evaluated
+  {
+    lazy_exact<T> unevaluated;
+    for (int i = 0; i < n; ++i)
+    {
+      unevaluated += tenth;
+    }
+  }
+}
+
+template <class T>
+void kernel_predicates()
+{
+  cout << "Testing kernel predicates on lazy points" << endl;
+
+  using Lazy_point = typename Kernel<T>::Lazy_point;
+  using L = lazy_exact<T>;
+  Kernel<T> k;
+  typename Kernel<T>::Statistics stats;
+
+  //c is (3 * 0.1, 0.1 + 0.1 + 0.1), which is exactly on the line y = x
+  Kernel<T>::clear_statistics();
+  const L tenth(T(0.1));
+  Lazy_point a(L(0), L(0));
+  Lazy_point b(L(1), L(1));
+  Lazy_point c(tenth * L(3), tenth + tenth + tenth);
+  Lazy_point d(L(0), L(1));
+  assert(k.orientation(a, b, c) == Kernel<T>::Orientation::collinear);
+  assert(k.orientation(a, b, d) == Kernel<T>::Orientation::left_turn);
+  Kernel<T>::get_statistics(stats);
+  assert(stats.orientation_total_count == 2);
+  assert(stats.orientation_exact_count == 1);
+
+  //e is (3 * 0.1 - (0.1 + 0.1 + 0.1) + 2, 2), which is on the circle
+  //through p, q, and r
+  Lazy_point p(L(0), L(0));
+  Lazy_point q(L(2), L(0));
+  Lazy_point r(L(0), L(2));
+  Lazy_point e(tenth * L(3) - (tenth + tenth + tenth) + L(2), L(2));
+  Lazy_point f(L(1), L(1));
+  assert(k.side_of_oriented_circle(p, q, r, e) ==
+    Kernel<T>::Oriented_side::on_boundary);
+  assert(k.side_of_oriented_circle(p, q, r, f) ==
+    Kernel<T>::Oriented_side::on_positive_side);
+}
+
+template <class T>
+void do_test()
+{
+  constructor_tests<T>();
+  arithmetic<T>();
+  sign<T>();
+  deep_expressions<T>();
+  kernel_predicates<T>();
+}
+
+int main()
+{
+  std::cout << "!!!!!!!! Test with float !!!!!!!!!!!" << std::endl;
+  do_test<float>();
+  std::cout << "!!!!!!!! Test with double !!!!!!!!!!!" << std::endl;
+  do_test<double>();
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
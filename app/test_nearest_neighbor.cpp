@@ -0,0 +1,117 @@
+#include "test_fixtures.hpp"
+#include "ra/nearest_neighbor.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace fixtures;
+using namespace ra::geometry;
+using namespace std;
+
+double squared_distance(const Point& a, const Point& b)
+{
+  return (a.x() - b.x()) * (a.x() - b.x()) + (a.y() - b.y()) * (a.y() - b.y());
+}
+
+// Get the sorted squared distances from p to its k nearest points.
+vector<double> brute_force(const vector<Point>& points, const Point& p,
+  size_t k)
+{
+  vector<double> distances;
+  for (const Point& q : points)
+  {
+    distances.push_back(squared_distance(p, q));
+  }
+  sort(distances.begin(), distances.end());
+  distances.resize(min(k, distances.size()));
+  return distances;
+}
+
+template <class Vertex_handle>
+vector<double> distances(const vector<Vertex_handle>& vertices,
+  const Point& p)
+{
+  vector<double> result;
+  for (const auto& v : vertices)
+  {
+    result.push_back(squared_distance(v->point(), p));
+  }
+  return result;
+}
+
+void test_nearest(const vector<Point>& points, const vector<Point>& queries)
+{
+  const Triangulation tri = make_delaunay(points);
+  Nearest_neighbor_search<const Triangulation> search(tri);
+  const size_t k = 12;
+
+  const auto nearest = search.nearest(queries, 3);
+  const auto k_nearest = search.k_nearest(queries, k, 3);
+  for (size_t i = 0; i < queries.size(); ++i)
+  {
+    const Point& p = queries[i];
+    const vector<double> expected = brute_force(points, p, k);
+    assert(squared_distance(search.nearest(p)->point(), p) == expected[0]);
+    assert(squared_distance(nearest[i]->point(), p) == expected[0]);
+    assert(distances(search.k_nearest(p, k), p) == expected);
+    assert(distances(k_nearest[i], p) == expected);
+  }
+
+  //more neighbours than vertices
+  assert(search.k_nearest(queries.front(), tri.size_of_vertices() + 5).size()
+    == size_t(tri.size_of_vertices()));
+}
+
+void test_random()
+{
+  cout << "Testing random points" << endl;
+
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> coordinate(0, 1);
+  vector<Point> points;
+  for (int i = 0; i < 3000; ++i)
+  {
+    points.emplace_back(coordinate(generator), coordinate(generator));
+  }
+  std::uniform_real_distribution<double> query(-0.5, 1.5);
+  vector<Point> queries(points.begin(), points.begin() + 100);
+  for (int i = 0; i < 2500; ++i)
+  {
+    queries.emplace_back(query(generator), query(generator));
+  }
+  test_nearest(points, queries);
+}
+
+void test_grid()
+{
+  cout << "Testing grid points" << endl;
+
+  //many ties
+  vector<Point> points;
+  for (int i = 0; i < 40; ++i)
+  {
+    for (int j = 0; j < 40; ++j)
+    {
+      points.emplace_back(i, j);
+    }
+  }
+  std::mt19937 generator(2);
+  std::uniform_int_distribution<int> coordinate(-10, 90);
+  vector<Point> queries;
+  for (int i = 0; i < 2000; ++i)
+  {
+    queries.emplace_back(coordinate(generator) / 2.0,
+      coordinate(generator) / 2.0);
+  }
+  test_nearest(points, queries);
+}
+
+int main()
+{
+  test_random();
+  test_grid();
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
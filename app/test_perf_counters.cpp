@@ -0,0 +1,67 @@
+#include "ra/perf_counters.hpp"
+#include <cassert>
+#include <iostream>
+
+using namespace ra::profiling;
+using namespace std;
+
+// Some work that takes a little CPU time.
+double work()
+{
+  volatile double sum = 0;
+  for (int i = 0; i < 1000000; ++i)
+  {
+    sum = sum + 1.0 / (i + 1);
+  }
+  return sum;
+}
+
+void counter_tests()
+{
+  cout << "Testing counters" << endl;
+
+  perf_counters counters;
+  for (int e = 0; e < perf_counters::event_count; ++e)
+  {
+    cout << "  " << perf_counters::name(e) << ": "
+      << (counters.available(e) ? "available" : "unavailable") << endl;
+  }
+
+  const perf_counters::reading unscaled_before = counters.read_unscaled();
+  const perf_counters::reading before = counters.read();
+  work();
+  const perf_counters::reading after = counters.read();
+  const perf_counters::reading unscaled_after = counters.read_unscaled();
+  const perf_counters::reading counts = after - before;
+  for (int e = 0; e < perf_counters::event_count; ++e)
+  {
+    //unavailable events read as zero, and unscaled counts do not decrease
+    //(scaled ones may, if the counters are multiplexed)
+    assert(counters.available(e) || (before[e] == 0 && after[e] == 0));
+    assert(counters.available(e) ||
+      (unscaled_before[e] == 0 && unscaled_after[e] == 0));
+    assert(unscaled_after[e] >= unscaled_before[e]);
+  }
+  if (counters.available(perf_counters::instructions))
+  {
+    assert(counts[perf_counters::instructions] >= 1000000);
+  }
+  if (counters.available(perf_counters::task_clock_ns))
+  {
+    assert(counts[perf_counters::task_clock_ns] > 0);
+  }
+
+  perf_counters::reading sum = counts;
+  sum += before;
+  for (int e = 0; e < perf_counters::event_count; ++e)
+  {
+    assert(sum[e] == after[e]);
+  }
+}
+
+int main()
+{
+  counter_tests();
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
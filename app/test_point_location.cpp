@@ -0,0 +1,126 @@
+#include "test_fixtures.hpp"
+#include "ra/point_location.hpp"
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace fixtures;
+using namespace ra::geometry;
+using namespace std;
+
+// Test whether p is in the closed face of the halfedge h.
+template <class Halfedge_handle>
+bool in_face(Halfedge_handle h, const Point& p)
+{
+  Kernel<double> kernel;
+  for (int i = 0; i < 3; ++i, h = h->next())
+  {
+    if (kernel.orientation(h->opposite()->vertex()->point(),
+      h->vertex()->point(), p) == Kernel<double>::Orientation::right_turn)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void test_locate()
+{
+  cout << "Testing locate" << endl;
+
+  const int n = 30;
+  const Triangulation tri = make_grid(n);
+  Point_locator<const Triangulation> locator(tri);
+
+  //at the vertices
+  for (auto v = tri.vertices_begin(); v != tri.vertices_end(); ++v)
+  {
+    const auto location = locator.locate(v->point());
+    assert(location.type == Locate_type::vertex);
+    assert(location.halfedge->vertex() == v);
+  }
+
+  //on the edges
+  for (auto h = tri.halfedges_begin(); h != tri.halfedges_end(); ++h)
+  {
+    const Point& a = h->opposite()->vertex()->point();
+    const Point& b = h->vertex()->point();
+    const Point p((a.x() + b.x()) / 2, (a.y() + b.y()) / 2);
+    const auto location = locator.locate(p);
+    assert(location.type == Locate_type::edge);
+    assert(location.halfedge == h || location.halfedge == h->opposite());
+    assert(!location.halfedge->is_border());
+  }
+
+  //inside the faces
+  for (auto f = tri.faces_begin(); f != tri.faces_end(); ++f)
+  {
+    const auto h = f->halfedge();
+    const Point& a = h->vertex()->point();
+    const Point& b = h->next()->vertex()->point();
+    const Point& c = h->next()->next()->vertex()->point();
+    const Point p((a.x() + b.x() + c.x()) / 3, (a.y() + b.y() + c.y()) / 3);
+    const auto location = locator.locate(p);
+    assert(location.type == Locate_type::face);
+    assert(location.halfedge->face() == f);
+  }
+
+  //outside the convex hull
+  for (const Point& p : {Point(-1, 3.5), Point(n + 2, n + 2),
+    Point(n / 2, -0.25), Point(-5, n - 1)})
+  {
+    const auto location = locator.locate(p);
+    assert(location.type == Locate_type::outside);
+    assert(location.halfedge->is_border());
+    assert(!in_face(location.halfedge->opposite(), p));
+  }
+}
+
+void test_locate_batch()
+{
+  cout << "Testing batch locate" << endl;
+
+  const int n = 30;
+  Triangulation tri = make_grid(n);
+  Point_locator<Triangulation> locator(tri);
+
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> coordinate(-1, n);
+  vector<Point> points;
+  for (int i = 0; i < 2000; ++i)
+  {
+    points.emplace_back(coordinate(generator), coordinate(generator));
+  }
+  const auto locations = locator.locate(points);
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    const auto location = locator.locate(points[i]);
+    assert(locations[i].type == location.type);
+    if (location.type == Locate_type::face)
+    {
+      assert(locations[i].halfedge->face() == location.halfedge->face());
+      assert(in_face(location.halfedge, points[i]));
+    }
+    else
+    {
+      assert(location.type == Locate_type::outside);
+      assert(points[i].x() < 0 || points[i].y() < 0 ||
+        points[i].x() > n - 1 || points[i].y() > n - 1);
+    }
+  }
+
+  //a walk from a hint
+  const auto location = locator.locate(Point(0.5, 0.25),
+    locations.front().halfedge);
+  assert(location.type == Locate_type::face);
+  assert(in_face(location.halfedge, Point(0.5, 0.25)));
+}
+
+int main()
+{
+  test_locate();
+  test_locate_batch();
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,129 @@
+#include "ra/pool_allocator.hpp"
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace ra::memory;
+using namespace std;
+
+struct node
+{
+  double x;
+  double y;
+  node* next;
+};
+
+void allocation_tests()
+{
+  cout << "Testing allocation" << endl;
+
+  pool_allocator<node> alloc;
+  vector<node*> nodes;
+  for (int i = 0; i < 10000; ++i)
+  {
+    node* p = alloc.allocate(1);
+    assert(reinterpret_cast<std::uintptr_t>(p) % alignof(node) == 0);
+    p->x = i;
+    nodes.push_back(p);
+  }
+  //the nodes are distinct and mostly adjacent
+  assert(set<node*>(nodes.begin(), nodes.end()).size() == nodes.size());
+  int adjacent = 0;
+  for (std::size_t i = 1; i < nodes.size(); ++i)
+  {
+    if (reinterpret_cast<char*>(nodes[i]) - reinterpret_cast<char*>(
+      nodes[i - 1]) == 32)
+    {
+      ++adjacent;
+    }
+  }
+  assert(adjacent > 9900);
+  for (int i = 0; i < 10000; ++i)
+  {
+    assert(nodes[i]->x == i);
+  }
+
+  //freed nodes are reused
+  node* last = nodes.back();
+  alloc.deallocate(last, 1);
+  assert(alloc.allocate(1) == last);
+  for (node* p : nodes)
+  {
+    alloc.deallocate(p, 1);
+  }
+
+  //pairs of nodes and large allocations
+  node* pair = alloc.allocate(2);
+  pair[1].x = 1;
+  alloc.deallocate(pair, 2);
+  node* array = alloc.allocate(1000);
+  array[999].x = 1;
+  alloc.deallocate(array, 1000);
+
+  //the sizes of the allocations, as far as the pools serve them
+  assert(pool_allocator<node>::node_size(1) == 32);
+  assert(pool_allocator<node>::node_size(2) == 48);
+  assert(pool_allocator<node>::node_size(1000) == 0);
+
+  //all instances are equal, also after a rebind
+  pool_allocator<int> other(alloc);
+  assert(other == alloc);
+  assert(!(other != alloc));
+}
+
+void container_tests()
+{
+  cout << "Testing containers" << endl;
+
+  list<int, pool_allocator<int>> values;
+  for (int i = 0; i < 1000; ++i)
+  {
+    values.push_back(i);
+  }
+  list<int, pool_allocator<int>> moved(std::move(values));
+  assert(moved.size() == 1000 && moved.back() == 999);
+  moved.clear();
+}
+
+void thread_tests()
+{
+  cout << "Testing threads" << endl;
+
+  //nodes allocated in one thread can be freed in another, and the free
+  //nodes of an exited thread are reused by the others
+  pool_allocator<node> alloc;
+  vector<node*> nodes;
+  std::thread([&] {
+    for (int i = 0; i < 1000; ++i)
+    {
+      nodes.push_back(alloc.allocate(1));
+    }
+  }).join();
+  for (node* p : nodes)
+  {
+    p->next = p;
+    alloc.deallocate(p, 1);
+  }
+  std::thread([&] {
+    for (int i = 0; i < 1000; ++i)
+    {
+      node* p = alloc.allocate(1);
+      p->next = nullptr;
+      alloc.deallocate(p, 1);
+    }
+  }).join();
+}
+
+int main()
+{
+  allocation_tests();
+  container_tests();
+  thread_tests();
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
@@ -0,0 +1,117 @@
+#include "ra/spatial_sort.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace ra::geometry;
+using namespace std;
+
+struct Point
+{
+  double x_;
+  double y_;
+  double x() const { return x_; }
+  double y() const { return y_; }
+};
+
+// Tell whether order is a permutation of the indices of points.
+bool is_permutation_of(const vector<size_t>& order,
+  const vector<Point>& points)
+{
+  vector<size_t> sorted = order;
+  sort(sorted.begin(), sorted.end());
+  vector<size_t> indices(points.size());
+  iota(indices.begin(), indices.end(), size_t(0));
+  return sorted == indices;
+}
+
+void check_orders(const vector<Point>& points)
+{
+  assert(is_permutation_of(hilbert_order(points), points));
+  assert(is_permutation_of(brio_order(points), points));
+  assert(is_permutation_of(brio_order(points, 1), points));
+}
+
+void test_hilbert_index()
+{
+  cout << "Testing Hilbert indices" << endl;
+
+  // The first 4^k cells along the curve fill the 2^k by 2^k block at
+  // the origin, and consecutive cells are adjacent.
+  const uint32_t n = 16;
+  vector<uint32_t> x(n * n, n);
+  vector<uint32_t> y(n * n, n);
+  for (uint32_t i = 0; i < n; ++i)
+  {
+    for (uint32_t j = 0; j < n; ++j)
+    {
+      const uint64_t d = hilbert_index(i, j);
+      assert(d < n * n);
+      assert(x[d] == n);
+      x[d] = i;
+      y[d] = j;
+    }
+  }
+  for (uint32_t d = 1; d < n * n; ++d)
+  {
+    assert(abs(int(x[d]) - int(x[d - 1])) + abs(int(y[d]) - int(y[d - 1]))
+      == 1);
+  }
+  assert(hilbert_index(0, 0) == 0);
+  const uint32_t max = (uint32_t(1) << 31) - 1;
+  assert(hilbert_index(max, 0) == (uint64_t(1) << 62) - 1);
+}
+
+void test_orders()
+{
+  cout << "Testing Hilbert and BRIO orders" << endl;
+
+  check_orders({});
+  check_orders({{1, 2}});
+  check_orders({{1, 2}, {1, 2}, {1, 2}});
+
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> coordinate(-1, 1);
+  vector<Point> points;
+  for (int i = 0; i < 1000; ++i)
+  {
+    points.push_back({coordinate(generator), coordinate(generator)});
+  }
+  check_orders(points);
+
+  // Duplicates of every point.
+  vector<Point> duplicates = points;
+  duplicates.insert(duplicates.end(), points.begin(), points.end());
+  check_orders(duplicates);
+
+  // Collinear points, along an axis and along a diagonal.
+  vector<Point> horizontal;
+  vector<Point> diagonal;
+  for (int i = 0; i < 500; ++i)
+  {
+    horizontal.push_back({double(i % 37), 0});
+    diagonal.push_back({double(i), double(i)});
+  }
+  check_orders(horizontal);
+  check_orders(diagonal);
+
+  // The Hilbert order of a line of points is sorted along the line.
+  const vector<size_t> order = hilbert_order(diagonal);
+  for (size_t i = 0; i < order.size(); ++i)
+  {
+    assert(order[i] == i);
+  }
+}
+
+int main()
+{
+  test_hilbert_index();
+  test_orders();
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
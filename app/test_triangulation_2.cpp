@@ -0,0 +1,179 @@
+#include "test_fixtures.hpp"
+#include "ra/pool_allocator.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace fixtures;
+using namespace std;
+
+using Pooled_triangulation = trilib::Triangulation_2<K,
+  ra::memory::pool_allocator<int>>;
+
+template <class Tri>
+void check_footprint(const Tri& tri)
+{
+  const auto footprint = tri.memory_footprint();
+  assert(footprint.vertices == size_t(tri.size_of_vertices()));
+  assert(footprint.halfedges == size_t(tri.size_of_halfedges()));
+  assert(footprint.faces == size_t(tri.size_of_faces()));
+  assert(footprint.vertex_bytes - footprint.point_bytes >=
+    sizeof(typename Tri::Vertex));
+  assert(footprint.halfedge_bytes >= sizeof(typename Tri::Halfedge));
+  assert(footprint.face_bytes >= sizeof(typename Tri::Face));
+  assert(footprint.total_bytes() == footprint.vertices *
+    footprint.vertex_bytes + footprint.halfedges * footprint.halfedge_bytes +
+    footprint.faces * footprint.face_bytes);
+}
+
+using Coordinates = pair<double, double>;
+
+Coordinates coordinates(const Point& p)
+{
+  return {p.x(), p.y()};
+}
+
+// Get the points of the vertices, in sorted order.
+vector<Coordinates> vertex_set(const Triangulation& tri)
+{
+  vector<Coordinates> vertices;
+  for (auto vi = tri.vertices_begin(); vi != tri.vertices_end(); ++vi)
+  {
+    vertices.push_back(coordinates(vi->point()));
+  }
+  sort(vertices.begin(), vertices.end());
+  return vertices;
+}
+
+// Get the faces as CCW triples of points, each rotated to start at its
+// smallest point, in sorted order.
+vector<array<Coordinates, 3>> face_set(const Triangulation& tri)
+{
+  vector<array<Coordinates, 3>> faces;
+  for (auto fi = tri.faces_begin(); fi != tri.faces_end(); ++fi)
+  {
+    const auto h = fi->halfedge();
+    array<Coordinates, 3> face{coordinates(h->vertex()->point()),
+      coordinates(h->next()->vertex()->point()),
+      coordinates(h->next()->next()->vertex()->point())};
+    assert(h->next()->next()->next() == h);
+    rotate(face.begin(), min_element(face.begin(), face.end()), face.end());
+    faces.push_back(face);
+  }
+  sort(faces.begin(), faces.end());
+  return faces;
+}
+
+// Check that a spatial sort keeps the vertices, faces, and edges.
+void check_spatial_sort(Triangulation& tri)
+{
+  const auto vertices = vertex_set(tri);
+  const auto faces = face_set(tri);
+  const auto halfedges = tri.size_of_halfedges();
+  tri.spatial_sort();
+  assert(vertex_set(tri) == vertices);
+  assert(face_set(tri) == faces);
+  assert(tri.size_of_halfedges() == halfedges);
+}
+
+void test_spatial_sort()
+{
+  cout << "Testing spatial sort" << endl;
+
+  std::mt19937 generator(6);
+  std::uniform_real_distribution<double> coordinate(0, 1);
+  vector<Point> points;
+  for (int i = 0; i < 2000; ++i)
+  {
+    points.emplace_back(coordinate(generator), coordinate(generator));
+  }
+  Triangulation tri = make_delaunay(points);
+  check_spatial_sort(tri);
+  // Sorting again changes nothing.
+  check_spatial_sort(tri);
+
+  Triangulation grid = make_grid(30);
+  check_spatial_sort(grid);
+
+  Triangulation triangle = make_delaunay({Point(0, 0), Point(1, 0),
+    Point(0, 1)});
+  check_spatial_sort(triangle);
+}
+
+void test_memory_footprint()
+{
+  cout << "Testing memory footprint" << endl;
+
+  std::mt19937 generator(5);
+  std::uniform_real_distribution<double> coordinate(0, 1);
+  vector<Point> points;
+  for (int i = 0; i < 1000; ++i)
+  {
+    points.emplace_back(coordinate(generator), coordinate(generator));
+  }
+  Triangulation tri = make_delaunay(points);
+  check_footprint(tri);
+  const auto footprint = tri.memory_footprint();
+  // The lookup tables of the construction hold every vertex and edge.
+  assert(footprint.construction_bytes >= footprint.vertices *
+    sizeof(Triangulation::Vertex_handle) + footprint.halfedges / 2 *
+    (2 * sizeof(Triangulation::Vertex_handle) +
+    sizeof(Triangulation::Halfedge_handle)));
+
+  //updates change the counts, but not the construction overhead
+  const auto h = tri.faces_begin()->halfedge();
+  const Point& a = h->vertex()->point();
+  const Point& b = h->next()->vertex()->point();
+  const Point& c = h->next()->next()->vertex()->point();
+  tri.create_center_vertex(h, Point((a.x() + b.x() + c.x()) / 3,
+    (a.y() + b.y() + c.y()) / 3));
+  check_footprint(tri);
+  const auto updated = tri.memory_footprint();
+  assert(updated.vertices == footprint.vertices + 1);
+  assert(updated.total_bytes() > footprint.total_bytes());
+  assert(updated.construction_bytes == footprint.construction_bytes);
+
+  //a spatial sort rebuilds the triangulation
+  tri.spatial_sort();
+  check_footprint(tri);
+  assert(tri.memory_footprint().total_bytes() == updated.total_bytes());
+  assert(tri.memory_footprint().construction_bytes > 0);
+
+  Triangulation moved(std::move(tri));
+  assert(moved.memory_footprint().total_bytes() == updated.total_bytes());
+  assert(tri.memory_footprint().total_bytes() == 0);
+  assert(tri.memory_footprint().construction_bytes == 0);
+}
+
+void test_pooled_memory_footprint()
+{
+  cout << "Testing memory footprint with a pool allocator" << endl;
+
+  std::vector<Point> points;
+  std::vector<std::array<int, 3>> faces;
+  for (const auto& p : {Point(0, 0), Point(1, 0), Point(1, 1), Point(0, 1)})
+  {
+    points.push_back(p);
+  }
+  faces.push_back({0, 1, 2});
+  faces.push_back({0, 2, 3});
+  const Pooled_triangulation tri(points, faces);
+  check_footprint(tri);
+  //the nodes come from the pools, which add no headers
+  const auto footprint = tri.memory_footprint();
+  using Allocator = ra::memory::pool_allocator<Pooled_triangulation::Face>;
+  assert(footprint.face_bytes == Allocator::node_size(1));
+}
+
+int main()
+{
+  test_spatial_sort();
+  test_memory_footprint();
+  test_pooled_memory_footprint();
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
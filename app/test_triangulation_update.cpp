@@ -0,0 +1,278 @@
+#include "test_fixtures.hpp"
+#include "ra/pd_delaunay_check.hpp"
+#include "ra/triangulation_update.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+using namespace fixtures;
+using namespace ra::geometry;
+using namespace std;
+
+using Edge = pair<pair<double, double>, pair<double, double>>;
+
+// Get the edges of the triangulation as pairs of coordinates.
+set<Edge> edges(const Triangulation& tri)
+{
+  set<Edge> result;
+  for (auto h = tri.halfedges_begin(); h != tri.halfedges_end(); ++h)
+  {
+    const Point& a = h->opposite()->vertex()->point();
+    const Point& b = h->vertex()->point();
+    result.emplace(make_pair(a.x(), a.y()), make_pair(b.x(), b.y()));
+  }
+  return result;
+}
+
+// Test that the triangulation is the PD-Delaunay triangulation of its
+// vertices (which is unique).
+void check_delaunay(const Triangulation& tri)
+{
+  assert(check_pd_delaunay(tri, u, v, 1, true).violations.empty());
+  vector<Point> points;
+  for (auto i = tri.vertices_begin(); i != tri.vertices_end(); ++i)
+  {
+    points.push_back(i->point());
+  }
+  assert(edges(tri) == edges(make_delaunay(points)));
+}
+
+void test_move(vector<Point> points, double step)
+{
+  Triangulation tri = make_delaunay(points);
+  std::mt19937 generator(1);
+  std::uniform_real_distribution<double> offset(-step, step);
+  for (int round = 0; round < 5; ++round)
+  {
+    vector<pair<Triangulation::Vertex_handle, Point>> moves;
+    int i = 0;
+    for (auto vi = tri.vertices_begin(); vi != tri.vertices_end(); ++vi, ++i)
+    {
+      if (i % 20 == round)
+      {
+        moves.emplace_back(vi, Point(vi->point().x() + offset(generator),
+          vi->point().y() + offset(generator)));
+      }
+    }
+    const auto result = move_vertices(tri, moves, u, v);
+    assert(result.rejected.size() < moves.size() / 2);
+    //the suspect lists hold at least the edges tested in a pass
+    assert(result.lop.passes == 0 || result.lop.suspect_bytes >=
+      result.lop.tests / result.lop.passes *
+      sizeof(Triangulation::Halfedge_handle));
+    for (const auto& move : moves)
+    {
+      const bool rejected = std::find(result.rejected.begin(),
+        result.rejected.end(), move.first) != result.rejected.end();
+      assert(rejected != (move.first->point() == move.second));
+    }
+    check_delaunay(tri);
+  }
+}
+
+void test_random()
+{
+  cout << "Testing random points" << endl;
+
+  std::mt19937 generator(2);
+  std::uniform_real_distribution<double> coordinate(0, 1);
+  vector<Point> points;
+  for (int i = 0; i < 2000; ++i)
+  {
+    points.emplace_back(coordinate(generator), coordinate(generator));
+  }
+  test_move(points, 0.01);
+}
+
+void test_grid()
+{
+  cout << "Testing grid points" << endl;
+
+  vector<Point> points;
+  for (int i = 0; i < 30; ++i)
+  {
+    for (int j = 0; j < 30; ++j)
+    {
+      points.emplace_back(i, j);
+    }
+  }
+  test_move(points, 0.25);
+}
+
+void test_rejected()
+{
+  cout << "Testing rejected moves" << endl;
+
+  const vector<Point> points = {Point(0, 0), Point(4, 0), Point(4, 4),
+    Point(0, 4), Point(2, 2)};
+  Triangulation tri = make_delaunay(points);
+  Triangulation::Vertex_handle center;
+  Triangulation::Vertex_handle corner;
+  for (auto vi = tri.vertices_begin(); vi != tri.vertices_end(); ++vi)
+  {
+    if (vi->point() == Point(2, 2))
+    {
+      center = vi;
+    }
+    if (vi->point() == Point(4, 4))
+    {
+      corner = vi;
+    }
+  }
+  //out of the convex hull, or making the border concave
+  const auto result = move_vertices(tri, {{center, Point(5, 2)},
+    {corner, Point(1, 1)}, {corner, Point(5, 5)}}, u, v);
+  assert(result.rejected.size() == 2);
+  assert(center->point() == Point(2, 2));
+  assert(corner->point() == Point(5, 5));
+  check_delaunay(tri);
+}
+
+// Insert the points into the triangulation in a random order, and then
+// remove vertices in a random order until count are left, checking the
+// triangulation as it goes.
+void test_insert_remove(Triangulation& tri, vector<Point> points,
+  size_t count)
+{
+  std::mt19937 generator(3);
+  std::shuffle(points.begin(), points.end(), generator);
+  Triangulation::Halfedge_handle hint = tri.halfedges_begin();
+  for (size_t i = 0; i < points.size(); ++i)
+  {
+    const auto vertex = insert_vertex(tri, points[i], hint, u, v);
+    assert(vertex->point() == points[i]);
+    hint = vertex->halfedge();
+    if (i % 500 == 0)
+    {
+      check_delaunay(tri);
+    }
+  }
+  check_delaunay(tri);
+
+  //inserting an existing point changes nothing
+  const size_t size = tri.size_of_vertices();
+  const Point p = points.front();
+  assert(insert_vertex(tri, p, u, v)->point() == p);
+  assert(tri.size_of_vertices() == size);
+
+  vector<Triangulation::Vertex_handle> vertices;
+  for (auto vi = tri.vertices_begin(); vi != tri.vertices_end(); ++vi)
+  {
+    vertices.push_back(vi);
+  }
+  std::shuffle(vertices.begin(), vertices.end(), generator);
+  vertices.resize(vertices.size() - count);
+  for (size_t i = 0; i < vertices.size(); ++i)
+  {
+    remove_vertex(tri, vertices[i], u, v);
+    if (i % 500 == 0)
+    {
+      check_delaunay(tri);
+    }
+  }
+  assert(tri.size_of_vertices() == count);
+  check_delaunay(tri);
+}
+
+void test_insert_remove_random()
+{
+  cout << "Testing insertion and removal of random points" << endl;
+
+  std::mt19937 generator(4);
+  std::uniform_real_distribution<double> coordinate(0, 1);
+  vector<Point> points;
+  for (int i = 0; i < 2000; ++i)
+  {
+    points.emplace_back(coordinate(generator), coordinate(generator));
+  }
+  Triangulation tri = make_delaunay({Point(0.4, 0.4), Point(0.6, 0.4),
+    Point(0.5, 0.6)});
+  test_insert_remove(tri, points, 10);
+}
+
+void test_insert_remove_grid()
+{
+  cout << "Testing insertion and removal of grid points" << endl;
+
+  //many points are inserted on edges, and on the lines through border
+  //edges
+  vector<Point> points;
+  for (int i = 0; i < 40; ++i)
+  {
+    for (int j = 0; j < 40; ++j)
+    {
+      if (i > 1 || j > 1)
+      {
+        points.emplace_back(i * 0.5, j * 0.5);
+      }
+    }
+  }
+  Triangulation tri = make_delaunay({Point(0, 0), Point(0.5, 0),
+    Point(0, 0.5)});
+  test_insert_remove(tri, points, 4);
+}
+
+// Get the number of edges incident on the vertex.
+size_t degree(Triangulation::Vertex_handle vertex)
+{
+  size_t result = 0;
+  auto h = vertex->halfedge();
+  do
+  {
+    ++result;
+    h = h->next()->opposite();
+  } while (h != vertex->halfedge());
+  return result;
+}
+
+void test_remove_square_corner()
+{
+  cout << "Testing removal of the corners of a square" << endl;
+
+  const vector<Point> points = {Point(0, 0), Point(1, 0), Point(1, 1),
+    Point(0, 1)};
+  for (size_t diagonal : {2, 3})
+  {
+    //removing an endpoint of the diagonal leaves both edges opposite to it
+    //without faces; removing another corner leaves the diagonal on the
+    //border
+    Triangulation tri = make_delaunay(points);
+    assert(tri.size_of_faces() == 2);
+    Triangulation::Vertex_handle corner;
+    for (auto vi = tri.vertices_begin(); vi != tri.vertices_end(); ++vi)
+    {
+      if (degree(vi) == diagonal)
+      {
+        corner = vi;
+      }
+    }
+    assert(corner != Triangulation::Vertex_handle());
+    const Point p = corner->point();
+    remove_vertex(tri, corner, u, v);
+    assert(tri.size_of_vertices() == 3);
+    assert(tri.size_of_edges() == 3);
+    assert(tri.size_of_faces() == 1);
+    for (auto vi = tri.vertices_begin(); vi != tri.vertices_end(); ++vi)
+    {
+      assert(vi->point() != p);
+      assert(degree(vi) == 2);
+    }
+    check_delaunay(tri);
+  }
+}
+
+int main()
+{
+  test_random();
+  test_grid();
+  test_rejected();
+  test_insert_remove_random();
+  test_insert_remove_grid();
+  test_remove_square_corner();
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
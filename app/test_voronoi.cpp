@@ -0,0 +1,132 @@
+#include "test_fixtures.hpp"
+#include "ra/voronoi.hpp"
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace fixtures;
+using namespace ra::geometry;
+using namespace std;
+
+// Check that the approximate coordinate x (with the error bound error)
+// contains the exact rational coordinate numerator / denominator.
+void check_coordinate(double x, double error, int64_t numerator,
+  int64_t denominator)
+{
+  const long double exact = (long double)numerator / denominator;
+  // Allow for the rounding of the long double quotient.
+  const long double slack = fabsl(exact) * 1e-18L;
+  assert(fabsl(exact - x) <= error + slack);
+}
+
+// Check that the diagram has one vertex per face (at its circumcenter),
+// and one edge per interior edge and one ray per border edge of the
+// triangulation.
+void check_diagram(const Triangulation& tri)
+{
+  const auto diagram = make_voronoi_diagram(tri);
+  assert(diagram.vertices.size() == size_t(tri.size_of_faces()));
+
+  size_t i = 0;
+  for (auto f = tri.faces_begin(); f != tri.faces_end(); ++f, ++i)
+  {
+    // The circumcenter of abc is a + (x, y) / d, with exact integer x, y,
+    // and d for points with small integer coordinates.
+    auto h = f->halfedge();
+    const Point& a = h->vertex()->point();
+    const Point& b = h->next()->vertex()->point();
+    const Point& c = h->next()->next()->vertex()->point();
+    const int64_t bx = b.x() - a.x();
+    const int64_t by = b.y() - a.y();
+    const int64_t cx = c.x() - a.x();
+    const int64_t cy = c.y() - a.y();
+    const int64_t b2 = bx * bx + by * by;
+    const int64_t c2 = cx * cx + cy * cy;
+    const int64_t d = 2 * (bx * cy - by * cx);
+    const int64_t x = cy * b2 - by * c2 + int64_t(a.x()) * d;
+    const int64_t y = bx * c2 - cx * b2 + int64_t(a.y()) * d;
+    const auto& vertex = diagram.vertices[i];
+    check_coordinate(vertex.point.x(), vertex.x_error, x, d);
+    check_coordinate(vertex.point.y(), vertex.y_error, y, d);
+  }
+
+  size_t interior_edges = 0;
+  size_t border_edges = 0;
+  for (auto h = tri.halfedges_begin(); h != tri.halfedges_end(); ++h)
+  {
+    if (h->is_border())
+    {
+      ++border_edges;
+    }
+    else if (!h->opposite()->is_border())
+    {
+      ++interior_edges;
+    }
+  }
+  interior_edges /= 2;
+  size_t edges = 0;
+  size_t rays = 0;
+  for (const auto& e : diagram.edges)
+  {
+    assert(e.source >= 0 && e.source < int(diagram.vertices.size()));
+    if (e.target < 0)
+    {
+      ++rays;
+    }
+    else
+    {
+      assert(e.target < int(diagram.vertices.size()));
+      assert(e.source != e.target);
+      ++edges;
+    }
+  }
+  assert(edges == interior_edges);
+  assert(rays == border_edges);
+}
+
+void test_triangle()
+{
+  cout << "Testing a triangle" << endl;
+  const Triangulation tri = make_delaunay({Point(0, 0), Point(4, 0),
+    Point(0, 2)});
+  check_diagram(tri);
+  const auto diagram = make_voronoi_diagram(tri);
+  assert(diagram.vertices.size() == 1);
+  assert(diagram.vertices[0].point == Point(2, 1));
+  assert(diagram.edges.size() == 3);
+}
+
+void test_random()
+{
+  cout << "Testing random integer points" << endl;
+  std::mt19937 generator(4);
+  std::uniform_int_distribution<int> coordinate(-100, 100);
+  for (int n : {4, 10, 50, 200})
+  {
+    vector<Point> points;
+    for (int i = 0; i < n; ++i)
+    {
+      points.emplace_back(coordinate(generator), coordinate(generator));
+    }
+    check_diagram(make_delaunay(points));
+  }
+}
+
+void test_grid()
+{
+  cout << "Testing a grid" << endl;
+  // Cocircular points, whose Voronoi vertices coincide.
+  check_diagram(make_grid(6));
+}
+
+int main()
+{
+  test_triangle();
+  test_random();
+  test_grid();
+  std::cout << "All tests passed" << std::endl;
+  return 0;
+}
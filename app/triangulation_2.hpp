@@ -33,10 +33,15 @@ reason, care should be taken to provide valid data to the input operation.
 // Includes
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <cassert>
 #include <set>
 #include <map>
+#include <memory>
+#include <type_traits>
 #include <vector>
 #include <exception>
 #include <CGAL/Cartesian.h>
@@ -45,6 +50,7 @@ reason, care should be taken to provide valid data to the input operation.
 #include <CGAL/HalfedgeDS_default.h>
 #include <CGAL/HalfedgeDS_decorator.h>
 #include <CGAL/HalfedgeDS_vertex_base.h>
+#include "ra/spatial_sort.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
@@ -57,7 +63,7 @@ namespace trilib {
 // For this reason, this code is deliberately undocumented.
 ////////////////////////////////////////////////////////////////////////////////
 
-template <class Kernel>
+template <class Kernel, class Allocator>
 class Make_halfedge_data_structure
 {
 private:
@@ -119,7 +125,27 @@ private:
 	    typedef typename Kernel::Point_2  Point;
 	};
 public:
-	using type = CGAL::HalfedgeDS_default<My_traits, My_items>;
+	using type = CGAL::HalfedgeDS_default<My_traits, My_items, Allocator>;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// A helper class for the Trangulation_2 class.
+// This code is for internal use only and should not be used directly.
+// For this reason, this code is deliberately undocumented.
+////////////////////////////////////////////////////////////////////////////////
+
+template <class Node_allocator, class = void>
+struct Allocator_node_size
+{
+	static std::size_t get(std::size_t) {return 0;}
+};
+
+template <class Node_allocator>
+struct Allocator_node_size<Node_allocator,
+  std::void_t<decltype(Node_allocator::node_size(std::size_t()))>>
+{
+	static std::size_t get(std::size_t n)
+	  {return Node_allocator::node_size(n);}
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -131,17 +157,24 @@ public:
 Template parameters:
 K    The geometry kernel to be used by the triangulation
      (e.g., CGAL::Cartesian<double>).
+A    The allocator used for the vertices, halfedges, and faces of the
+     halfedge data structure (e.g., ra::memory::pool_allocator<int>).
+     The allocator is rebound to each node type, and it must be
+     stateless, since the halfedge data structure default-constructs it.
 */
 
-template <typename K>
+template <typename K, typename A = std::allocator<int>>
 class Triangulation_2 {
 public:
 
 	// The geometry kernel used by the class.
 	using Kernel = K;
 
+	// The allocator used by the class.
+	using Allocator = A;
+
 	// The halfedge data structure used by the class.
-	using HDS = typename Make_halfedge_data_structure<Kernel>::type;
+	using HDS = typename Make_halfedge_data_structure<Kernel, Allocator>::type;
 
 	// The point (in 2-D) type.
 	// For the interface provided by Point, see:
@@ -227,9 +260,31 @@ public:
 	*/
 	Triangulation_2(std::istream& in);
 
-	// The triangulation type is not movable.
-	Triangulation_2(Triangulation_2&&) = delete;
-	Triangulation_2& operator=(Triangulation_2&&) = delete;
+	/*
+	Construct a triangulation from points and faces in memory.
+	The triangulation has the vertices points (in order) and the faces
+	faces, each face being given by the indices into points of its three
+	vertices in counterclockwise order.  The type Points must be a range
+	of Point (e.g., std::vector<Point>), and the type Faces must be a
+	range of triples that can be indexed by 0, 1, and 2 (e.g.,
+	std::vector<std::array<int, 3>>).
+	The same conditions apply as for a triangulation read in OFF format
+	(i.e., the faces must form a triangulation whose border is the convex
+	hull of the points).
+	Upon failure, an exception is thrown.  The type of the thrown exception is
+	either std::exception or an type derived therefrom.
+	In cases of invalid input data (other than out-of-range vertex
+	indices), std::abort might be called.
+	*/
+	template <class Points, class Faces>
+	Triangulation_2(const Points& points, const Faces& faces);
+
+	/*
+	The triangulation type is movable.
+	A moved-from triangulation is empty.
+	*/
+	Triangulation_2(Triangulation_2&& other);
+	Triangulation_2& operator=(Triangulation_2&& other);
 
 	// The triangulation type is not copyable.
 	Triangulation_2(const Triangulation_2&) = delete;
@@ -322,6 +377,89 @@ public:
 	*/
 	Halfedge_handle flip_edge(Halfedge_handle h);
 
+	/*
+	Insert a new vertex into a face.
+	A new vertex with the point p is created in the face of the halfedge h,
+	and is connected to each of the vertices of the face, splitting the
+	face into triangles.
+	Precondition:
+	The halfedge h is not a border halfedge, and p is in the interior of its
+	face.
+	Return value:
+	A halfedge whose target is the new vertex is returned.
+	*/
+	Halfedge_handle create_center_vertex(Halfedge_handle h, const Point& p);
+
+	/*
+	Insert a new vertex into an edge.
+	A new vertex with the point p is created on the edge associated with
+	the halfedge h, splitting the edge in two, and is connected to the
+	opposite vertex of each (non-border) face incident on the edge.
+	Precondition:
+	The point p is in the interior of the edge.
+	Return value:
+	The halfedge h, which now has the new vertex as its target, is returned.
+	*/
+	Halfedge_handle split_edge(Halfedge_handle h, const Point& p);
+
+	/*
+	Split a face with a new edge.
+	A new edge is created between the target vertices of the halfedges h
+	and g, which belong to the same face, splitting the face in two.
+	Precondition:
+	The halfedges h and g are distinct halfedges of the same (non-border)
+	face, neither is the next halfedge of the other, and the new edge is a
+	diagonal in the interior of the face.
+	Return value:
+	The new halfedge from the target of h to the target of g is returned.
+	*/
+	Halfedge_handle split_face(Halfedge_handle h, Halfedge_handle g);
+
+	/*
+	Remove a vertex and its incident edges.
+	The vertex v and all of its incident edges are removed.  If v is not on
+	the border, its incident faces are merged into a single face (which in
+	general is not a triangle, and must be split with split_face);
+	otherwise, they are removed, and the edges opposite to v become border
+	edges.  An edge opposite to v that is a border edge already (e.g., each
+	edge opposite to a corner of a triangulated square that the diagonal
+	ends at) is left with no incident face, and the border runs along it
+	in both directions; the border is still a single cycle, and faces can
+	be added to it with add_face_to_border (and add_vertex_to_border)
+	until every edge has a face again.
+	Return value:
+	A halfedge of the merged face is returned; if v was on the border, the
+	border halfedge that replaces the first border edge incident on v is
+	returned.
+	*/
+	Halfedge_handle erase_center_vertex(Vertex_handle v);
+
+	/*
+	Add a new vertex outside the border.
+	A new vertex with the point p is created, along with a face that has
+	the new vertex and the edge associated with the border halfedge h.
+	Precondition:
+	The halfedge h is a border halfedge, and p is strictly on the outer side
+	of its edge.
+	Return value:
+	The halfedge of the new face from the target of h to the new vertex is
+	returned.
+	*/
+	Halfedge_handle add_vertex_to_border(Halfedge_handle h, const Point& p);
+
+	/*
+	Add a face in a concave corner of the border.
+	A new face is created with the edges associated with the border
+	halfedges h and h->next() and a new edge between their far ends.
+	Precondition:
+	The halfedges h and h->next() are border halfedges that turn strictly
+	to the left (so that the new face is counterclockwise).
+	Return value:
+	The new border halfedge, which replaces h and h->next() on the border,
+	is returned.
+	*/
+	Halfedge_handle add_face_to_border(Halfedge_handle h);
+
 	/*
 	Read a triangulation from an input stream in OFF format.
 	A triangulation is read in OFF format from the input stream in.
@@ -338,11 +476,79 @@ public:
 	*/
 	bool output_off(std::ostream& out) const;
 
+	/*
+	Reorder the vertices, faces, and halfedges of the triangulation for
+	memory locality.
+	The vertices are renumbered in the order of a Hilbert curve through
+	their points, and the faces (and with them, the halfedges) in the order
+	of a Hilbert curve through the face centroids.  Neighbouring elements
+	therefore tend to be stored close together, which speeds up traversals
+	such as edge-flipping sweeps.  The iteration order (and therefore the
+	order used by output_off) follows the new numbering.
+	The triangulation itself (i.e., its vertices, edges, and faces) is not
+	changed.
+	All handles and iterators are invalidated.
+	*/
+	void spatial_sort();
+
+	/*
+	The memory used by a triangulation.
+	The bytes per vertex, halfedge, and face are those of the blocks of
+	memory allocated for each (including the bookkeeping overhead of the
+	allocator, as far as it can be estimated for the allocator in use).
+	The bytes per vertex include its point, which is allocated separately
+	if the point type is a handle to a shared representation (as in
+	CGAL::Cartesian).
+	The construction overhead is the memory used by the lookup tables of
+	the vertices, edges, faces, and border halfedges while the
+	triangulation was being built from its faces, in addition to the
+	triangulation itself; the peak memory used by the construction is
+	therefore the total plus the construction overhead.
+	*/
+	struct Memory_footprint {
+		// The numbers of vertices, halfedges, and faces.
+		std::size_t vertices;
+		std::size_t halfedges;
+		std::size_t faces;
+		// The bytes per vertex (including its point).
+		std::size_t vertex_bytes;
+		// The bytes per vertex allocated separately for its point (if any).
+		std::size_t point_bytes;
+		// The bytes per halfedge.
+		std::size_t halfedge_bytes;
+		// The bytes per face.
+		std::size_t face_bytes;
+		// The peak construction overhead in bytes.
+		std::size_t construction_bytes;
+		// Get the bytes used by all vertices, halfedges, and faces.
+		std::size_t total_bytes() const
+		  {return vertices * vertex_bytes + halfedges * halfedge_bytes +
+		  faces * face_bytes;}
+	};
+
+	/*
+	Get the memory used by the triangulation.
+	The construction overhead is that of the most recent construction of
+	the triangulation from an input stream or from points and faces, or by
+	spatial_sort (or zero for a moved-from triangulation); other updates do
+	not change it.
+	*/
+	Memory_footprint memory_footprint() const;
+
 private:
 
+	static void link(Halfedge_handle h, Halfedge_handle next);
+	Halfedge_handle create_edge(Vertex_handle a, Vertex_handle b);
+	Vertex_handle create_vertex(const Point& p);
+
+	static std::size_t heap_block_size(std::size_t size);
+	template <class T>
+	static std::size_t node_block_size(std::size_t n);
+
 	class Builder;
 	friend class Builder;
 	HDS hds_;
+	std::size_t construction_bytes_ = 0;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -352,11 +558,11 @@ private:
 // For this reason, this code is deliberately undocumented.
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename Kernel>
-struct Triangulation_2<Kernel>::Builder
+template <typename Kernel, typename Allocator>
+struct Triangulation_2<Kernel, Allocator>::Builder
 {
 public:
-	using Triangulation = Triangulation_2<Kernel>;
+	using Triangulation = Triangulation_2<Kernel, Allocator>;
 	using Point = Triangulation::Point;
 	Builder();
 	~Builder();
@@ -365,6 +571,7 @@ public:
 	void add_vertex(const Point& p);
 	void add_face(int va, int vb, int vc);
 	bool apply(Triangulation& tri);
+	std::size_t memory_overhead() const;
 
 private:
 
@@ -398,23 +605,25 @@ private:
 	Edge_lut edge_lut_;
 	Face_list face_list_;
 	Halfedge_set border_halfedges_;
+	std::size_t max_border_halfedges_;
 	HDS hds_;
 
 };
 
-template <typename Kernel>
-Triangulation_2<Kernel>::Builder::Builder()
+template <typename Kernel, typename Allocator>
+Triangulation_2<Kernel, Allocator>::Builder::Builder()
 {
 	num_vertices_ = 0;
+	max_border_halfedges_ = 0;
 }
 
-template <typename Kernel>
-Triangulation_2<Kernel>::Builder::~Builder()
+template <typename Kernel, typename Allocator>
+Triangulation_2<Kernel, Allocator>::Builder::~Builder()
 {
 }
 
-template <typename Kernel>
-void Triangulation_2<Kernel>::Builder::add_vertex(const Point& p)
+template <typename Kernel, typename Allocator>
+void Triangulation_2<Kernel, Allocator>::Builder::add_vertex(const Point& p)
 {
 #if (TRIANGULATION_2_DEBUG_LEVEL >= 1)
 	std::cerr << "adding vertex " << num_vertices_ << " " << p << "\n";
@@ -427,8 +636,8 @@ void Triangulation_2<Kernel>::Builder::add_vertex(const Point& p)
 	++num_vertices_;
 }
 
-template <typename Kernel>
-auto Triangulation_2<Kernel>::Builder::lookup_halfedge(Vertex_handle va,
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::Builder::lookup_halfedge(Vertex_handle va,
   Vertex_handle vb) -> Halfedge_handle
 {
 	Halfedge_handle result;
@@ -456,6 +665,8 @@ auto Triangulation_2<Kernel>::Builder::lookup_halfedge(Vertex_handle va,
 		if (va->halfedge() == typename HDS::Halfedge_handle()) {
 			va->set_halfedge(result->opposite());
 		}
+		max_border_halfedges_ = std::max(max_border_halfedges_,
+		  border_halfedges_.size());
 	} else {
 		Halfedge_handle halfedge = i->second;
 		result = halfedge;
@@ -470,8 +681,8 @@ auto Triangulation_2<Kernel>::Builder::lookup_halfedge(Vertex_handle va,
 	return result;
 }
 
-template <typename Kernel>
-void Triangulation_2<Kernel>::Builder::add_face(int vai, int vbi, int vci)
+template <typename Kernel, typename Allocator>
+void Triangulation_2<Kernel, Allocator>::Builder::add_face(int vai, int vbi, int vci)
 {
 #if (TRIANGULATION_2_DEBUG_LEVEL >= 1)
 	std::cerr << "adding face " << vai << " " << vbi << " " << vci << "\n";
@@ -533,8 +744,8 @@ void Triangulation_2<Kernel>::Builder::add_face(int vai, int vbi, int vci)
 	}
 }
 
-template <typename Kernel>
-bool Triangulation_2<Kernel>::Builder::apply(Triangulation_2& tri)
+template <typename Kernel, typename Allocator>
+bool Triangulation_2<Kernel, Allocator>::Builder::apply(Triangulation_2& tri)
 {
 #if (TRIANGULATION_2_DEBUG_LEVEL >= 1)
 	std::cerr << "apply\n";
@@ -580,7 +791,12 @@ bool Triangulation_2<Kernel>::Builder::apply(Triangulation_2& tri)
 		}
 	}
 
-	border_halfedge = *border_halfedges_.begin();
+	if (border_halfedges_.empty()) {
+		std::cerr << "no faces\n";
+		valid = false;
+	} else {
+		border_halfedge = *border_halfedges_.begin();
+	}
 
 	if (valid) {
 		Halfedge_handle cur_halfedge = border_halfedge;
@@ -651,18 +867,34 @@ bool Triangulation_2<Kernel>::Builder::apply(Triangulation_2& tri)
 	}
 
 	if (valid) {
+		tri.construction_bytes_ = memory_overhead();
 		tri.hds_ = std::move(hds_);
 	}
 
 	return valid;
 }
 
+template <typename Kernel, typename Allocator>
+std::size_t Triangulation_2<Kernel, Allocator>::Builder::memory_overhead() const
+{
+	// The node of a map or set is taken to be that of the usual red-black
+	// tree (a colour and three links, followed by the value).
+	const std::size_t tree_node = 4 * sizeof(void*);
+	return vertex_lut_.size() * heap_block_size(tree_node +
+	  sizeof(typename Vertex_lut::value_type)) +
+	  edge_lut_.size() * heap_block_size(tree_node +
+	  sizeof(typename Edge_lut::value_type)) +
+	  heap_block_size(face_list_.capacity() * sizeof(Face_handle)) +
+	  max_border_halfedges_ * heap_block_size(tree_node +
+	  sizeof(Halfedge_handle));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Code for Triangulation_2 class.
 ////////////////////////////////////////////////////////////////////////////////
 
-template <typename Kernel>
-Triangulation_2<Kernel>::Triangulation_2(std::istream& in)
+template <typename Kernel, typename Allocator>
+Triangulation_2<Kernel, Allocator>::Triangulation_2(std::istream& in)
 {
 	hds_.clear();
 	if (!input_off(in)) {
@@ -670,10 +902,56 @@ Triangulation_2<Kernel>::Triangulation_2(std::istream& in)
 	}
 }
 
-template <typename Kernel>
-bool Triangulation_2<Kernel>::input_off(std::istream& in)
+template <typename Kernel, typename Allocator>
+template <class Points, class Faces>
+Triangulation_2<Kernel, Allocator>::Triangulation_2(const Points& points,
+  const Faces& faces)
+{
+	Triangulation_2::Builder builder;
+	int num_vertices = 0;
+	for (const auto& p : points) {
+		builder.add_vertex(p);
+		++num_vertices;
+	}
+	for (const auto& f : faces) {
+		for (int i = 0; i < 3; ++i) {
+			if (f[i] < 0 || f[i] >= num_vertices) {
+				std::cerr << "invalid vertex index\n";
+				throw std::exception();
+			}
+		}
+		builder.add_face(f[0], f[1], f[2]);
+	}
+	if (!builder.apply(*this)) {
+		throw std::exception();
+	}
+}
+
+template <typename Kernel, typename Allocator>
+Triangulation_2<Kernel, Allocator>::Triangulation_2(Triangulation_2&& other)
+{
+	hds_.swap(other.hds_);
+	std::swap(construction_bytes_, other.construction_bytes_);
+}
+
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::operator=(Triangulation_2&& other)
+  -> Triangulation_2&
+{
+	if (this != &other) {
+		hds_.swap(other.hds_);
+		other.hds_.clear();
+		construction_bytes_ = other.construction_bytes_;
+		other.construction_bytes_ = 0;
+	}
+	return *this;
+}
+
+template <typename Kernel, typename Allocator>
+bool Triangulation_2<Kernel, Allocator>::input_off(std::istream& in)
 {
 	hds_.clear();
+	construction_bytes_ = 0;
 	Triangulation_2::Builder builder;
 	std::string signature;
 	if (!(in >> signature) || signature != "OFF") {
@@ -724,8 +1002,8 @@ bool Triangulation_2<Kernel>::input_off(std::istream& in)
 	return true;
 }
 
-template <typename Kernel>
-bool Triangulation_2<Kernel>::output_off(std::ostream& out) const
+template <typename Kernel, typename Allocator>
+bool Triangulation_2<Kernel, Allocator>::output_off(std::ostream& out) const
 {
 	out << "OFF\n";
 	out << hds_.size_of_vertices() << " " << hds_.size_of_faces() << " "
@@ -749,8 +1027,107 @@ bool Triangulation_2<Kernel>::output_off(std::ostream& out) const
 	return bool(out);
 }
 
-template <typename Kernel>
-auto Triangulation_2<Kernel>::flip_edge(Halfedge_handle h) -> Halfedge_handle
+template <typename Kernel, typename Allocator>
+void Triangulation_2<Kernel, Allocator>::spatial_sort()
+{
+	std::vector<Point> points;
+	points.reserve(hds_.size_of_vertices());
+	std::map<Vertex_const_handle, int> vertex_lut;
+	for (auto vi = hds_.vertices_begin(); vi != hds_.vertices_end(); ++vi) {
+		vertex_lut[vi] = points.size();
+		points.push_back(vi->point());
+	}
+	std::vector<std::array<int, 3>> faces;
+	std::vector<Point> centroids;
+	faces.reserve(hds_.size_of_faces());
+	centroids.reserve(hds_.size_of_faces());
+	for (auto fi = hds_.faces_begin(); fi != hds_.faces_end(); ++fi) {
+		Halfedge_const_handle h = fi->halfedge();
+		const Point& a = h->vertex()->point();
+		const Point& b = h->next()->vertex()->point();
+		const Point& c = h->next()->next()->vertex()->point();
+		faces.push_back({vertex_lut[h->vertex()],
+		  vertex_lut[h->next()->vertex()],
+		  vertex_lut[h->next()->next()->vertex()]});
+		centroids.push_back(Point((a.x() + b.x() + c.x()) / 3,
+		  (a.y() + b.y() + c.y()) / 3));
+	}
+	vertex_lut.clear();
+
+	std::vector<std::size_t> vertex_order = ra::geometry::hilbert_order(points);
+	std::vector<int> vertex_rank(points.size());
+	for (std::size_t i = 0; i < vertex_order.size(); ++i) {
+		vertex_rank[vertex_order[i]] = i;
+	}
+	std::vector<std::size_t> face_order =
+	  ra::geometry::hilbert_order(centroids);
+
+	// The builder creates halfedges in the order in which faces are added,
+	// so the halfedges follow the face order.
+	Triangulation_2::Builder builder;
+	for (std::size_t i : vertex_order) {
+		builder.add_vertex(points[i]);
+	}
+	for (std::size_t i : face_order) {
+		builder.add_face(vertex_rank[faces[i][0]], vertex_rank[faces[i][1]],
+		  vertex_rank[faces[i][2]]);
+	}
+	hds_.clear();
+	if (!builder.apply(*this)) {
+		// This should not happen, since the triangulation was valid.
+		assert(false);
+		abort();
+	}
+}
+
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::memory_footprint() const ->
+  Memory_footprint
+{
+	using FT = typename Kernel::FT;
+	Memory_footprint result;
+	result.vertices = hds_.size_of_vertices();
+	result.halfedges = hds_.size_of_halfedges();
+	result.faces = hds_.size_of_faces();
+	// A point smaller than its coordinates is a handle to a reference-counted
+	// representation, which is allocated with std::allocator.
+	result.point_bytes = sizeof(Point) < 2 * sizeof(FT) ?
+	  heap_block_size(2 * sizeof(FT) + sizeof(void*)) : 0;
+	result.vertex_bytes = node_block_size<Vertex>(1) + result.point_bytes;
+	// The halfedges of an edge are allocated together.
+	result.halfedge_bytes = node_block_size<Halfedge>(2) / 2;
+	result.face_bytes = node_block_size<Face>(1);
+	result.construction_bytes = construction_bytes_;
+	return result;
+}
+
+template <typename Kernel, typename Allocator>
+std::size_t Triangulation_2<Kernel, Allocator>::heap_block_size(
+  std::size_t size)
+{
+	// As for the GNU C library: a header of one word, and blocks that are
+	// multiples of two words, of at least four words.
+	const std::size_t word = sizeof(std::size_t);
+	return std::max(4 * word, (size + word + 2 * word - 1) / (2 * word) *
+	  (2 * word));
+}
+
+template <typename Kernel, typename Allocator>
+template <class T>
+std::size_t Triangulation_2<Kernel, Allocator>::node_block_size(
+  std::size_t n)
+{
+	// An allocator may tell the size of its allocations (as
+	// ra::memory::pool_allocator does); otherwise, they are taken to come
+	// from the heap.
+	using Node_allocator = typename std::allocator_traits<Allocator>::
+	  template rebind_alloc<T>;
+	const std::size_t size = Allocator_node_size<Node_allocator>::get(n);
+	return size != 0 ? size : heap_block_size(n * sizeof(T));
+}
+
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::flip_edge(Halfedge_handle h) -> Halfedge_handle
 {
 	CGAL::HalfedgeDS_items_decorator<HDS> decorator;
 	//std::cerr << "flipping edge\n";
@@ -759,6 +1136,234 @@ auto Triangulation_2<Kernel>::flip_edge(Halfedge_handle h) -> Halfedge_handle
 	return result;
 }
 
+template <typename Kernel, typename Allocator>
+void Triangulation_2<Kernel, Allocator>::link(Halfedge_handle h,
+  Halfedge_handle next)
+{
+	h->set_next(next);
+	next->set_prev(h);
+}
+
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::create_edge(Vertex_handle a,
+  Vertex_handle b) -> Halfedge_handle
+{
+	Halfedge_handle h = hds_.edges_push_back(typename HDS::Halfedge(),
+	  typename HDS::Halfedge());
+	h->set_vertex(b);
+	h->opposite()->set_vertex(a);
+	return h;
+}
+
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::create_vertex(const Point& p) ->
+  Vertex_handle
+{
+	Vertex v;
+	v.point() = p;
+	return hds_.vertices_push_back(v);
+}
+
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::create_center_vertex(Halfedge_handle h,
+  const Point& p) -> Halfedge_handle
+{
+	assert(!h->is_border());
+	std::vector<Halfedge_handle> boundary;
+	Halfedge_handle g = h;
+	do {
+		boundary.push_back(g);
+		g = g->next();
+	} while (g != h);
+	const std::size_t n = boundary.size();
+
+	// The spoke i is the halfedge from the target of the boundary
+	// halfedge i to the new vertex.
+	Vertex_handle center = create_vertex(p);
+	std::vector<Halfedge_handle> spokes(n);
+	for (std::size_t i = 0; i < n; ++i) {
+		spokes[i] = create_edge(boundary[i]->vertex(), center);
+	}
+	center->set_halfedge(spokes[0]);
+	for (std::size_t i = 0; i < n; ++i) {
+		Face_handle face = i == 0 ? h->face() : hds_.faces_push_back(Face());
+		Halfedge_handle a = boundary[i];
+		Halfedge_handle b = spokes[i];
+		Halfedge_handle c = spokes[(i + n - 1) % n]->opposite();
+		link(a, b);
+		link(b, c);
+		link(c, a);
+		a->set_face(face);
+		b->set_face(face);
+		c->set_face(face);
+		face->set_halfedge(a);
+	}
+	return spokes[0];
+}
+
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::split_edge(Halfedge_handle h,
+  const Point& p) -> Halfedge_handle
+{
+	// The halfedge h (from a to b) becomes the halfedge from a to the new
+	// vertex m, its opposite becomes the halfedge from m to a, and a new
+	// edge joins m and b.
+	Halfedge_handle o = h->opposite();
+	Vertex_handle b = h->vertex();
+	Vertex_handle m = create_vertex(p);
+	Halfedge_handle n = create_edge(m, b);
+	h->set_vertex(m);
+	n->set_face(h->face());
+	n->opposite()->set_face(o->face());
+	link(n, h->next());
+	link(h, n);
+	link(o->prev(), n->opposite());
+	link(n->opposite(), o);
+	m->set_halfedge(h);
+	if (b->halfedge() == h) {
+		b->set_halfedge(n);
+	}
+	if (!h->is_border()) {
+		split_face(h, n->next());
+	}
+	if (!o->is_border()) {
+		split_face(n->opposite(), o->next());
+	}
+	return h;
+}
+
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::split_face(Halfedge_handle h,
+  Halfedge_handle g) -> Halfedge_handle
+{
+	assert(!h->is_border() && h->face() == g->face());
+	assert(h != g && h->next() != g && g->next() != h);
+	Halfedge_handle hn = h->next();
+	Halfedge_handle gn = g->next();
+	Halfedge_handle e = create_edge(h->vertex(), g->vertex());
+	link(h, e);
+	link(e, gn);
+	link(g, e->opposite());
+	link(e->opposite(), hn);
+	Face_handle face = h->face();
+	e->set_face(face);
+	face->set_halfedge(h);
+	Face_handle other = hds_.faces_push_back(Face());
+	other->set_halfedge(e->opposite());
+	Halfedge_handle i = e->opposite();
+	do {
+		i->set_face(other);
+		i = i->next();
+	} while (i != e->opposite());
+	return e;
+}
+
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::erase_center_vertex(Vertex_handle v)
+  -> Halfedge_handle
+{
+	// The halfedges whose target is v (one for each incident edge), with
+	// a border halfedge (if any) first.
+	std::vector<Halfedge_handle> spokes;
+	Halfedge_handle h = v->halfedge();
+	do {
+		spokes.push_back(h);
+		if (h->is_border()) {
+			std::swap(spokes.front(), spokes.back());
+		}
+		h = h->next()->opposite();
+	} while (h != v->halfedge());
+	const bool on_border = spokes.front()->is_border();
+
+	// The incident faces, and the edges opposite to v (one in each face).
+	std::vector<Face_handle> faces;
+	std::vector<Halfedge_handle> links;
+	for (Halfedge_handle s : spokes) {
+		if (!s->is_border()) {
+			faces.push_back(s->face());
+			links.push_back(s->prev());
+		}
+	}
+	Halfedge_handle result = spokes.front()->opposite()->next();
+	for (Halfedge_handle s : spokes) {
+		Vertex_handle w = s->opposite()->vertex();
+		if (w->halfedge() == s->opposite()) {
+			w->set_halfedge(s->prev());
+		}
+		link(s->prev(), s->opposite()->next());
+	}
+	Face_handle face = on_border ? Face_handle() : faces.front();
+	for (Halfedge_handle l : links) {
+		l->set_face(face);
+	}
+	if (!on_border) {
+		face->set_halfedge(result);
+	}
+
+	for (std::size_t i = on_border ? 0 : 1; i < faces.size(); ++i) {
+		hds_.faces_erase(faces[i]);
+	}
+	for (Halfedge_handle s : spokes) {
+		hds_.edges_erase(s);
+	}
+	hds_.vertices_erase(v);
+	return result;
+}
+
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::add_vertex_to_border(Halfedge_handle h,
+  const Point& p) -> Halfedge_handle
+{
+	assert(h->is_border());
+	// The halfedge h goes from x to y on the border, which now goes from
+	// x to the new vertex c and on to y.
+	Halfedge_handle hp = h->prev();
+	Halfedge_handle hn = h->next();
+	Vertex_handle x = h->opposite()->vertex();
+	Vertex_handle y = h->vertex();
+	Vertex_handle c = create_vertex(p);
+	Halfedge_handle yc = create_edge(y, c);
+	Halfedge_handle cx = create_edge(c, x);
+	c->set_halfedge(yc);
+	Face_handle face = hds_.faces_push_back(Face());
+	link(h, yc);
+	link(yc, cx);
+	link(cx, h);
+	h->set_face(face);
+	yc->set_face(face);
+	cx->set_face(face);
+	face->set_halfedge(h);
+	link(hp, cx->opposite());
+	link(cx->opposite(), yc->opposite());
+	link(yc->opposite(), hn);
+	cx->opposite()->set_face(Face_handle());
+	yc->opposite()->set_face(Face_handle());
+	return yc;
+}
+
+template <typename Kernel, typename Allocator>
+auto Triangulation_2<Kernel, Allocator>::add_face_to_border(Halfedge_handle h)
+  -> Halfedge_handle
+{
+	Halfedge_handle g = h->next();
+	assert(h->is_border() && g->is_border());
+	Halfedge_handle hp = h->prev();
+	Halfedge_handle gn = g->next();
+	Halfedge_handle e = create_edge(g->vertex(), h->opposite()->vertex());
+	Face_handle face = hds_.faces_push_back(Face());
+	link(h, g);
+	link(g, e);
+	link(e, h);
+	h->set_face(face);
+	g->set_face(face);
+	e->set_face(face);
+	face->set_halfedge(h);
+	link(hp, e->opposite());
+	link(e->opposite(), gn);
+	e->opposite()->set_face(Face_handle());
+	return e->opposite();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -0,0 +1,440 @@
+#ifndef divide_and_conquer_delaunay_hpp
+#define divide_and_conquer_delaunay_hpp
+
+#include "kernel.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <future>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace ra::geometry{
+
+// Builds the preferred-directions Delaunay (PD-Delaunay) triangulation of
+// a set of points with the divide-and-conquer algorithm of Guibas and
+// Stolfi.
+// The points are sorted lexicographically, split in half recursively, and
+// the triangulations of the two halves are merged bottom to top.  The only
+// predicates used by the merge are Kernel::orientation and
+// Kernel::side_of_oriented_circle with strict tests, which yields a
+// Delaunay triangulation but triangulates cocircular point sets
+// arbitrarily.  A final pass flips every edge that fails
+// Kernel::is_locally_pd_delaunay_edge; in a Delaunay triangulation only
+// edges inside cocircular clusters can fail, so the pass is cheap and
+// makes the output unique.
+// With more than one thread, the upper levels of the recursion run the
+// two halves in parallel.  The half handed to another thread is built in
+// an edge store of its own, which is appended (with its edge numbers
+// offset) to the store of the other half before the merge; the edges are
+// then numbered exactly as in a sequential run, so the output does not
+// depend on the number of threads.
+template <class R>
+class Divide_and_conquer_delaunay
+{
+    public:
+    // The type used to represent real numbers.
+    using Real = R;
+    // The geometry kernel providing the predicates.
+    using Kernel = ra::geometry::Kernel<R>;
+    // The type used to represent points in two dimensions.
+    using Point = typename Kernel::Point;
+    // The type used to represent vectors in two dimensions.
+    using Vector = typename Kernel::Vector;
+    // A triangle given by the indices of its vertices in CCW order.
+    using Triangle = std::array<int, 3>;
+
+    // Create a triangulator that resolves cocircular configurations with
+    // the first and second preferred directions u and v, and uses up to
+    // thread_count threads.
+    // Precondition: The vectors u and v are not zero vectors; the vectors
+    // u and v are neither parallel nor orthogonal.
+    Divide_and_conquer_delaunay(const Vector& u, const Vector& v,
+      unsigned thread_count = 1) :
+      u_(u), v_(v), thread_count_(std::max(1u, thread_count)) {}
+    ~Divide_and_conquer_delaunay() = default;
+    Divide_and_conquer_delaunay(const Divide_and_conquer_delaunay&) =
+      default;
+    Divide_and_conquer_delaunay& operator=(
+      const Divide_and_conquer_delaunay&) = default;
+    Divide_and_conquer_delaunay(Divide_and_conquer_delaunay&&) = default;
+    Divide_and_conquer_delaunay& operator=(Divide_and_conquer_delaunay&&) =
+      default;
+
+    // Triangulate the given points.
+    // Upon success, vertices holds the distinct input points (duplicates
+    // are dropped, otherwise the input order is kept), triangles holds the
+    // faces of the PD-Delaunay triangulation as indices into vertices, and
+    // true is returned.  If the points are all collinear (so that no
+    // triangulation exists), false is returned.
+    bool triangulate(const std::vector<Point>& points,
+      std::vector<Point>& vertices, std::vector<Triangle>& triangles)
+    {
+      vertices.clear();
+      triangles.clear();
+      next_.clear();
+      origin_.clear();
+      points_ = &points;
+      worker_statistics_ = typename Kernel::Statistics();
+
+      // Sort the points lexicographically and drop duplicates.
+      std::vector<int> sorted(points.size());
+      std::iota(sorted.begin(), sorted.end(), 0);
+      std::stable_sort(sorted.begin(), sorted.end(), [&](int a, int b) {
+        return points[a].x() < points[b].x() ||
+          (points[a].x() == points[b].x() && points[a].y() < points[b].y());
+      });
+      sorted.erase(std::unique(sorted.begin(), sorted.end(),
+        [&](int a, int b) { return points[a] == points[b]; }), sorted.end());
+      if (sorted.size() < 3)
+      {
+        points_ = nullptr;
+        return false;
+      }
+
+      next_.reserve(4 * 3 * sorted.size());
+      origin_.reserve(4 * 3 * sorted.size());
+      const int hull = triangulate(sorted, 0, int(sorted.size()),
+        thread_count_).first;
+      make_pd_delaunay(hull);
+
+      std::vector<bool> kept(points.size(), false);
+      for (int i : sorted)
+      {
+        kept[i] = true;
+      }
+      std::vector<int> index(points.size(), -1);
+      for (std::size_t i = 0; i < points.size(); ++i)
+      {
+        if (kept[i])
+        {
+          index[i] = int(vertices.size());
+          vertices.push_back(points[i]);
+        }
+      }
+
+      // The outer face lies to the right of the hull edge returned by the
+      // top-level call.  Every other face is a CCW triangle.
+      std::vector<bool> visited(next_.size(), false);
+      for (int e = sym(hull); !visited[e]; e = lnext(e))
+      {
+        visited[e] = true;
+      }
+      for (int e = 0; e < int(next_.size()); e += 2)
+      {
+        if (visited[e] || origin_[e] < 0)
+        {
+          continue;
+        }
+        const int e1 = lnext(e);
+        const int e2 = lnext(e1);
+        visited[e] = visited[e1] = visited[e2] = true;
+        triangles.push_back({index[org(e)], index[org(e1)],
+          index[org(e2)]});
+      }
+      points_ = nullptr;
+      return !triangles.empty();
+    }
+
+    // Get the kernel statistics of the tests made by the other threads
+    // during the last call of triangulate.  (The tests made by the calling
+    // thread are counted in its own statistics, as usual.)
+    const typename Kernel::Statistics& worker_statistics() const
+    {
+      return worker_statistics_;
+    }
+
+    private:
+    // The edge algebra of the quad-edge data structure.  Each edge has
+    // four consecutive records: the edge, its dual, its reverse, and the
+    // reverse of its dual.  Only the primal records (even numbers) carry
+    // an origin; a deleted edge has an origin of -2.
+    static int rot(int e) { return (e & ~3) | ((e + 1) & 3); }
+    static int sym(int e) { return (e & ~3) | ((e + 2) & 3); }
+    static int rot_inv(int e) { return (e & ~3) | ((e + 3) & 3); }
+    int onext(int e) const { return next_[e]; }
+    int oprev(int e) const { return rot(onext(rot(e))); }
+    int lnext(int e) const { return rot(onext(rot_inv(e))); }
+    int rprev(int e) const { return onext(sym(e)); }
+    int org(int e) const { return origin_[e]; }
+    int dest(int e) const { return origin_[sym(e)]; }
+    const Point& point(int i) const { return (*points_)[i]; }
+
+    int make_edge(int a, int b)
+    {
+      const int e = int(next_.size());
+      next_.insert(next_.end(), {e, e + 3, e + 2, e + 1});
+      origin_.insert(origin_.end(), {a, -1, b, -1});
+      return e;
+    }
+
+    void splice(int a, int b)
+    {
+      const int alpha = rot(onext(a));
+      const int beta = rot(onext(b));
+      std::swap(next_[a], next_[b]);
+      std::swap(next_[alpha], next_[beta]);
+    }
+
+    // Add an edge from the destination of a to the origin of b, so that
+    // a, the new edge, and b share a left face.
+    int connect(int a, int b)
+    {
+      const int e = make_edge(dest(a), org(b));
+      splice(e, lnext(a));
+      splice(sym(e), b);
+      return e;
+    }
+
+    void delete_edge(int e)
+    {
+      splice(e, oprev(e));
+      splice(sym(e), oprev(sym(e)));
+      origin_[e] = origin_[sym(e)] = -2;
+    }
+
+    // Rotate the edge e within the quadrilateral formed by its two faces.
+    void swap_edge(int e)
+    {
+      const int a = oprev(e);
+      const int b = oprev(sym(e));
+      splice(e, a);
+      splice(sym(e), b);
+      splice(e, lnext(a));
+      splice(sym(e), lnext(b));
+      origin_[e] = dest(a);
+      origin_[sym(e)] = dest(b);
+    }
+
+    bool ccw(int a, int b, int c)
+    {
+      return kernel_.orientation(point(a), point(b), point(c)) ==
+        Kernel::Orientation::left_turn;
+    }
+
+    bool right_of(int x, int e) { return ccw(x, dest(e), org(e)); }
+    bool left_of(int x, int e) { return ccw(x, org(e), dest(e)); }
+
+    // Tests if the point d is strictly inside the circle through the
+    // points a, b, and c (in CCW order).
+    bool in_circle(int a, int b, int c, int d)
+    {
+      return kernel_.side_of_oriented_circle(point(a), point(b), point(c),
+        point(d)) == Kernel::Oriented_side::on_positive_side;
+    }
+
+    // Triangulate the points sorted[lo..hi-1] using up to thread_count
+    // threads.  Returns the CCW convex hull edge out of the leftmost vertex
+    // and the CW convex hull edge out of the rightmost vertex.
+    std::pair<int, int> triangulate(const std::vector<int>& sorted, int lo,
+      int hi, unsigned thread_count)
+    {
+      const int n = hi - lo;
+      if (n == 2)
+      {
+        const int a = make_edge(sorted[lo], sorted[lo + 1]);
+        return {a, sym(a)};
+      }
+      if (n == 3)
+      {
+        const int s1 = sorted[lo];
+        const int s2 = sorted[lo + 1];
+        const int s3 = sorted[lo + 2];
+        const int a = make_edge(s1, s2);
+        const int b = make_edge(s2, s3);
+        splice(sym(a), b);
+        if (ccw(s1, s2, s3))
+        {
+          connect(b, a);
+          return {a, sym(b)};
+        }
+        if (ccw(s1, s3, s2))
+        {
+          const int c = connect(b, a);
+          return {sym(c), c};
+        }
+        return {a, sym(b)};
+      }
+
+      const int mid = lo + n / 2;
+      int ldo, ldi, rdi, rdo;
+      if (thread_count > 1 && n >= parallel_cutoff)
+      {
+        // Build the right half in another thread, in a store of its own.
+        Divide_and_conquer_delaunay right(u_, v_);
+        right.points_ = points_;
+        right.next_.reserve(4 * 3 * std::size_t(hi - mid));
+        right.origin_.reserve(4 * 3 * std::size_t(hi - mid));
+        // The future waits for the worker even if the left half throws,
+        // and get passes on an exception thrown by the worker.
+        std::future<std::pair<int, int>> worker = std::async(
+          std::launch::async, [&] {
+          Kernel::clear_statistics();
+          const auto hull = right.triangulate(sorted, mid, hi,
+            thread_count / 2);
+          typename Kernel::Statistics statistics;
+          Kernel::get_statistics(statistics);
+          Kernel::accumulate_statistics(right.worker_statistics_,
+            statistics);
+          return hull;
+        });
+        std::tie(ldo, ldi) = triangulate(sorted, lo, mid,
+          thread_count - thread_count / 2);
+        const std::pair<int, int> right_hull = worker.get();
+        const int offset = int(next_.size());
+        for (int e : right.next_)
+        {
+          next_.push_back(e + offset);
+        }
+        origin_.insert(origin_.end(), right.origin_.begin(),
+          right.origin_.end());
+        rdi = right_hull.first + offset;
+        rdo = right_hull.second + offset;
+        Kernel::accumulate_statistics(worker_statistics_,
+          right.worker_statistics_);
+      }
+      else
+      {
+        std::tie(ldo, ldi) = triangulate(sorted, lo, mid, 1);
+        std::tie(rdi, rdo) = triangulate(sorted, mid, hi, 1);
+      }
+
+      // Find the lower common tangent of the two halves.
+      for (;;)
+      {
+        if (left_of(org(rdi), ldi))
+        {
+          ldi = lnext(ldi);
+        }
+        else if (right_of(org(ldi), rdi))
+        {
+          rdi = rprev(rdi);
+        }
+        else
+        {
+          break;
+        }
+      }
+
+      int basel = connect(sym(rdi), ldi);
+      if (org(ldi) == org(ldo))
+      {
+        ldo = sym(basel);
+      }
+      if (org(rdi) == org(rdo))
+      {
+        rdo = basel;
+      }
+
+      // Merge upwards from the lower common tangent.
+      for (;;)
+      {
+        int lcand = onext(sym(basel));
+        if (right_of(dest(lcand), basel))
+        {
+          while (in_circle(dest(basel), org(basel), dest(lcand),
+            dest(onext(lcand))))
+          {
+            const int t = onext(lcand);
+            delete_edge(lcand);
+            lcand = t;
+          }
+        }
+        int rcand = oprev(basel);
+        if (right_of(dest(rcand), basel))
+        {
+          while (in_circle(dest(basel), org(basel), dest(rcand),
+            dest(oprev(rcand))))
+          {
+            const int t = oprev(rcand);
+            delete_edge(rcand);
+            rcand = t;
+          }
+        }
+        const bool lvalid = right_of(dest(lcand), basel);
+        const bool rvalid = right_of(dest(rcand), basel);
+        if (!lvalid && !rvalid)
+        {
+          break;
+        }
+        // The next cross edge goes either to the left or to the right
+        // candidate; choose the one whose triangle has an empty circle.
+        if (!lvalid || (rvalid && in_circle(dest(lcand), org(lcand),
+          org(rcand), dest(rcand))))
+        {
+          basel = connect(rcand, sym(basel));
+        }
+        else
+        {
+          basel = connect(sym(basel), sym(lcand));
+        }
+      }
+      return {ldo, rdo};
+    }
+
+    // Flip every interior edge that does not have the PD-Delaunay
+    // property.  The triangulation is Delaunay already, so only edges
+    // inside cocircular clusters can be flipped.
+    void make_pd_delaunay(int hull)
+    {
+      std::vector<bool> outer(next_.size(), false);
+      for (int e = sym(hull); !outer[e]; e = lnext(e))
+      {
+        outer[e] = true;
+      }
+      std::vector<int> stack;
+      for (int e = 0; e < int(next_.size()); e += 4)
+      {
+        if (origin_[e] >= 0)
+        {
+          stack.push_back(e);
+        }
+      }
+      while (!stack.empty())
+      {
+        const int e = stack.back();
+        stack.pop_back();
+        if (outer[e] || outer[sym(e)])
+        {
+          continue;
+        }
+        // The edge ac with the CCW faces acb and cad.
+        const int a = org(e);
+        const int c = dest(e);
+        const int b = dest(lnext(e));
+        const int d = dest(lnext(sym(e)));
+        if (!kernel_.is_locally_pd_delaunay_edge(point(c), point(b),
+          point(a), point(d), u_, v_))
+        {
+          const int e1 = lnext(e);
+          const int e2 = lnext(e1);
+          const int e3 = lnext(sym(e));
+          const int e4 = lnext(e3);
+          swap_edge(e);
+          for (int f : {e1, e2, e3, e4})
+          {
+            stack.push_back(f & ~3);
+          }
+        }
+      }
+    }
+
+    // The smallest number of points that is split between two threads.
+    static constexpr int parallel_cutoff = 1 << 14;
+
+    Kernel kernel_;
+    Vector u_;
+    Vector v_;
+    unsigned thread_count_;
+    typename Kernel::Statistics worker_statistics_ =
+      typename Kernel::Statistics();
+    const std::vector<Point>* points_ = nullptr;
+    std::vector<int> next_;
+    std::vector<int> origin_;
+};
+
+}
+
+#endif
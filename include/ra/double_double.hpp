@@ -0,0 +1,218 @@
+#ifndef double_double_hpp
+#define double_double_hpp
+
+#include "interval.hpp"
+#include <cmath>
+
+namespace ra
+{
+namespace math {
+
+// A number represented as the unevaluated sum hi + lo of two doubles
+// (about 106 significant bits) together with a radius: the exact value
+// lies within radius of hi + lo.
+// Additions and multiplications use the error-free transformations
+// two-sum and two-product, and each operation adds a bound on its own
+// error (and on the error of the radius computation itself) to the
+// radius.  The sign is therefore certified unless the value is within
+// its radius of zero, in which case sign throws indeterminate_result,
+// just as for an interval.
+// The arithmetic assumes that the rounding mode is round-to-nearest.
+class double_double{
+  public:
+    using real_type = double;
+
+    struct statistics {
+      // The total number of indeterminate results encountered.
+      unsigned long indeterminate_result_count ;
+      // The total number of double-double arithmetic operations.
+      unsigned long arithmetic_op_count ;
+    };
+
+    double_double(real_type real_val = real_type(0)) : hi_(real_val),
+      lo_(0), radius_(0) { }
+
+    double_double(double_double&&) = default;
+    double_double& operator=(double_double&&) = default;
+
+    double_double(const double_double&) = default;
+    double_double& operator=(const double_double&) = default;
+
+    ~double_double() = default;
+
+    double_double& operator+=(const double_double& other)
+    {
+      // Dekker's addition, with a relative error of a few units of
+      // 2^-106 with respect to |a| + |b|.
+      real_type s1, s2, t1, t2;
+      two_sum(hi_, other.hi_, s1, s2);
+      two_sum(lo_, other.lo_, t1, t2);
+      s2 += t1;
+      quick_two_sum(s1, s2, s1, s2);
+      s2 += t2;
+      const real_type error = rounding_error * (magnitude() +
+        other.magnitude());
+      quick_two_sum(s1, s2, hi_, lo_);
+      radius_ = (radius_ + other.radius_ + error + underflow_error) *
+        radius_inflation;
+      ++stats_.arithmetic_op_count;
+      return *this;
+    }
+
+    double_double& operator-=(const double_double& other)
+    {
+      return operator+=(-other);
+    }
+
+    double_double& operator*=(const double_double& other)
+    {
+      // The product of the high parts is exact; the cross terms are
+      // added in double precision, and the product of the low parts
+      // (less than 2^-106 relative) is neglected.
+      real_type p1, p2;
+      two_prod(hi_, other.hi_, p1, p2);
+      p2 += hi_ * other.lo_ + lo_ * other.hi_;
+      const real_type a = magnitude();
+      const real_type b = other.magnitude();
+      const real_type propagated = a * other.radius_ + b * radius_ +
+        radius_ * other.radius_;
+      quick_two_sum(p1, p2, hi_, lo_);
+      radius_ = (propagated + rounding_error * a * b + underflow_error) *
+        radius_inflation;
+      ++stats_.arithmetic_op_count;
+      return *this;
+    }
+
+    double_double operator-() const
+    {
+      double_double result(*this);
+      result.hi_ = -hi_;
+      result.lo_ = -lo_;
+      return result;
+    }
+
+    // Get the high part of the midpoint.
+    real_type hi() const
+    {
+      return hi_;
+    }
+
+    // Get the low part of the midpoint.
+    real_type lo() const
+    {
+      return lo_;
+    }
+
+    // Get the bound on the distance from the midpoint to the exact value.
+    real_type radius() const
+    {
+      return radius_;
+    }
+
+    // Get the sign of the exact value.
+    // If the sign cannot be determined, an exception of type
+    // indeterminate_result is thrown.
+    int sign() const
+    {
+      // Since |lo| is at most half an ulp of hi, the midpoint has the
+      // sign of hi and a magnitude of at least |hi| / 2.
+      if (radius_ < std::abs(hi_) / 2)
+      {
+        return hi_ > 0 ? 1 : -1;
+      }
+      if (hi_ == 0 && radius_ == 0)
+      {
+        return 0;
+      }
+      ++stats_.indeterminate_result_count;
+      throw indeterminate_result("Could not determine the sign");
+    }
+
+    static void clear_statistics()
+    {
+      stats_.indeterminate_result_count = 0;
+      stats_.arithmetic_op_count = 0;
+    }
+
+    static void get_statistics(statistics& stats)
+    {
+      stats.indeterminate_result_count = stats_.indeterminate_result_count;
+      stats.arithmetic_op_count = stats_.arithmetic_op_count;
+    }
+
+  private:
+    // A bound on the relative error of an operation (about 64 times the
+    // error of Dekker's algorithms, to leave room for the neglected
+    // terms).
+    static constexpr real_type rounding_error = 0x1p-100;
+    // A bound on the absolute error caused by underflow in an operation.
+    static constexpr real_type underflow_error = 0x1p-1060;
+    // A factor that covers the rounding errors of the computation of the
+    // radius.
+    static constexpr real_type radius_inflation = 1 + 0x1p-48;
+
+    // Get an upper bound on |hi + lo|.
+    real_type magnitude() const
+    {
+      return std::abs(hi_) * (1 + 0x1p-52);
+    }
+
+    // Compute s = fl(a + b) and the error e = a + b - s exactly.
+    static void two_sum(real_type a, real_type b, real_type& s, real_type& e)
+    {
+      s = a + b;
+      const real_type bb = s - a;
+      e = (a - (s - bb)) + (b - bb);
+    }
+
+    // As two_sum, if |a| >= |b|.
+    static void quick_two_sum(real_type a, real_type b, real_type& s,
+      real_type& e)
+    {
+      s = a + b;
+      e = b - (s - a);
+    }
+
+    // Compute p = fl(a * b) and the error e = a * b - p exactly (unless
+    // it underflows).
+    static void two_prod(real_type a, real_type b, real_type& p, real_type& e)
+    {
+      p = a * b;
+      e = std::fma(a, b, -p);
+    }
+
+    real_type hi_;
+    real_type lo_;
+    real_type radius_;
+
+    // The statistics are kept per thread.
+    static thread_local statistics stats_;
+};
+
+  inline thread_local double_double::statistics double_double::stats_ = {0,0};
+
+  inline double_double operator+(const double_double& a, const double_double& b)
+  {
+      double_double tmp(a);
+      tmp.operator+=(b);
+      return tmp;
+  }
+
+  //binary minus
+  inline double_double operator-(const double_double& a, const double_double& b)
+  {
+      double_double tmp(a);
+      tmp.operator-=(b);
+      return tmp;
+  }
+
+  //binary multiply
+  inline double_double operator*(const double_double& a, const double_double& b)
+  {
+      double_double tmp(a);
+      tmp.operator*=(b);
+      return tmp;
+  }
+}
+}
+#endif
@@ -0,0 +1,397 @@
+#ifndef incremental_delaunay_hpp
+#define incremental_delaunay_hpp
+
+#include "kernel.hpp"
+#include "spatial_sort.hpp"
+#include <array>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace ra::geometry{
+
+// Builds the preferred-directions Delaunay (PD-Delaunay) triangulation of
+// a set of points by incremental insertion.
+// Points are inserted in BRIO order.  Each point is located by walking
+// through the triangulation with Kernel::orientation, the triangle (or
+// edge) containing it is split, and the PD-Delaunay property is restored
+// by flipping edges that fail Kernel::is_locally_pd_delaunay_edge.
+// The region outside the convex hull is covered by "ghost" triangles that
+// share a single vertex at infinity, so that points outside the current
+// hull need no special treatment beyond a visibility test.
+template <class R>
+class Incremental_delaunay
+{
+    public:
+    // The type used to represent real numbers.
+    using Real = R;
+    // The geometry kernel providing the predicates.
+    using Kernel = ra::geometry::Kernel<R>;
+    // The type used to represent points in two dimensions.
+    using Point = typename Kernel::Point;
+    // The type used to represent vectors in two dimensions.
+    using Vector = typename Kernel::Vector;
+    // A triangle given by the indices of its vertices in CCW order.
+    using Triangle = std::array<int, 3>;
+
+    // Create a triangulator that resolves cocircular configurations with
+    // the first and second preferred directions u and v.
+    // Precondition: The vectors u and v are not zero vectors; the vectors
+    // u and v are neither parallel nor orthogonal.
+    Incremental_delaunay(const Vector& u, const Vector& v) :
+      u_(u), v_(v) {}
+    ~Incremental_delaunay() = default;
+    Incremental_delaunay(const Incremental_delaunay&) = default;
+    Incremental_delaunay& operator=(const Incremental_delaunay&) = default;
+    Incremental_delaunay(Incremental_delaunay&&) = default;
+    Incremental_delaunay& operator=(Incremental_delaunay&&) = default;
+
+    // Triangulate the given points.
+    // Upon success, vertices holds the distinct input points (duplicates
+    // are dropped, otherwise the input order is kept), triangles holds the
+    // faces of the PD-Delaunay triangulation as indices into vertices, and
+    // true is returned.  If the points are all collinear (so that no
+    // triangulation exists), false is returned.
+    bool triangulate(const std::vector<Point>& points,
+      std::vector<Point>& vertices, std::vector<Triangle>& triangles)
+    {
+      vertices.clear();
+      triangles.clear();
+      faces_.clear();
+      points_ = &points;
+
+      const std::vector<std::size_t> order = brio_order(points);
+      if (!make_initial_triangle(order))
+      {
+        return false;
+      }
+      for (std::size_t i : order)
+      {
+        if (!inserted_[i])
+        {
+          insert(int(i));
+        }
+      }
+
+      // Drop duplicate points and renumber the remaining ones.
+      std::vector<int> index(points.size(), -1);
+      for (std::size_t i = 0; i < points.size(); ++i)
+      {
+        if (inserted_[i])
+        {
+          index[i] = int(vertices.size());
+          vertices.push_back(points[i]);
+        }
+      }
+      for (const Face& f : faces_)
+      {
+        if (!is_ghost(f))
+        {
+          triangles.push_back({index[f.v[0]], index[f.v[1]],
+            index[f.v[2]]});
+        }
+      }
+      points_ = nullptr;
+      return true;
+    }
+
+    private:
+    // The index of the vertex at infinity.
+    static constexpr int infinite = -1;
+
+    // A triangle with its three neighbours.  The neighbour n[i] is across
+    // the edge opposite the vertex v[i].
+    struct Face
+    {
+      std::array<int, 3> v;
+      std::array<int, 3> n;
+    };
+
+    const Point& point(int i) const
+    {
+      return (*points_)[i];
+    }
+
+    static bool is_ghost(const Face& f)
+    {
+      return f.v[0] == infinite || f.v[1] == infinite || f.v[2] == infinite;
+    }
+
+    static int index_of(const Face& f, int vertex)
+    {
+      return f.v[0] == vertex ? 0 : (f.v[1] == vertex ? 1 : 2);
+    }
+
+    // Point the neighbour link of face f that refers to from at to.
+    void relink(int f, int from, int to)
+    {
+      Face& face = faces_[f];
+      for (int& n : face.n)
+      {
+        if (n == from)
+        {
+          n = to;
+          return;
+        }
+      }
+    }
+
+    int add_face(int a, int b, int c, int na, int nb, int nc)
+    {
+      faces_.push_back(Face{{a, b, c}, {na, nb, nc}});
+      return int(faces_.size()) - 1;
+    }
+
+    // Build the first (real) triangle and the three ghost triangles
+    // around it from the first three non-collinear points in order.
+    bool make_initial_triangle(const std::vector<std::size_t>& order)
+    {
+      inserted_.assign(points_->size(), false);
+      if (order.size() < 3)
+      {
+        return false;
+      }
+      const int a = int(order[0]);
+      int b = -1;
+      int c = -1;
+      for (std::size_t i = 1; i < order.size() && c < 0; ++i)
+      {
+        const int p = int(order[i]);
+        if (b < 0)
+        {
+          if (point(p) != point(a))
+          {
+            b = p;
+          }
+        }
+        else if (kernel_.orientation(point(a), point(b), point(p)) !=
+          Kernel::Orientation::collinear)
+        {
+          c = p;
+        }
+      }
+      if (c < 0)
+      {
+        return false;
+      }
+      if (kernel_.orientation(point(a), point(b), point(c)) ==
+        Kernel::Orientation::right_turn)
+      {
+        std::swap(b, c);
+      }
+      // Face 0 is abc; faces 1, 2, and 3 are the ghosts beyond the edges
+      // bc, ca, and ab, respectively.
+      faces_.reserve(2 * points_->size() + 2);
+      add_face(a, b, c, 1, 2, 3);
+      add_face(c, b, infinite, 3, 2, 0);
+      add_face(a, c, infinite, 1, 3, 0);
+      add_face(b, a, infinite, 2, 1, 0);
+      inserted_[a] = inserted_[b] = inserted_[c] = true;
+      last_ = 0;
+      return true;
+    }
+
+    enum class Location { face, edge, vertex, outside };
+
+    // Find the face containing the point p by walking from the most
+    // recently created face.  If p lies on an edge, edge is set to the
+    // index (in the returned face) of the vertex opposite that edge.
+    // Since the triangulation is always PD-Delaunay, the walk terminates;
+    // choosing the first edge at random guards against pathological
+    // cycling on degenerate input.
+    int locate(const Point& p, Location& location, int& edge)
+    {
+      int f = last_;
+      int previous = -1;
+      for (;;)
+      {
+        const Face& face = faces_[f];
+        if (is_ghost(face))
+        {
+          location = Location::outside;
+          return f;
+        }
+        const int start = int(random_() % 3);
+        int zeros = 0;
+        int next = -1;
+        for (int k = 0; k < 3; ++k)
+        {
+          const int i = (start + k) % 3;
+          // The point is known to be strictly to the left of the edge
+          // through which this face was entered.
+          if (face.n[i] == previous)
+          {
+            continue;
+          }
+          const auto o = kernel_.orientation(point(face.v[(i + 1) % 3]),
+            point(face.v[(i + 2) % 3]), p);
+          if (o == Kernel::Orientation::right_turn)
+          {
+            next = face.n[i];
+            break;
+          }
+          if (o == Kernel::Orientation::collinear)
+          {
+            ++zeros;
+            edge = i;
+          }
+        }
+        if (next < 0)
+        {
+          location = zeros == 0 ? Location::face :
+            (zeros == 1 ? Location::edge : Location::vertex);
+          return f;
+        }
+        previous = f;
+        f = next;
+      }
+    }
+
+    // Split face f into three faces that share the new vertex p.
+    // Returns the indices of the three faces.
+    std::array<int, 3> split_face(int f, int p)
+    {
+      const Face old = faces_[f];
+      const int f1 = int(faces_.size());
+      const int f2 = f1 + 1;
+      faces_[f] = Face{{old.v[0], old.v[1], p}, {f1, f2, old.n[2]}};
+      add_face(old.v[1], old.v[2], p, f2, f, old.n[0]);
+      add_face(old.v[2], old.v[0], p, f, f1, old.n[1]);
+      relink(old.n[0], f, f1);
+      relink(old.n[1], f, f2);
+      return {f, f1, f2};
+    }
+
+    // Flip the edge opposite the vertex with index i in face f.
+    // If a is that vertex and d is the vertex opposite the same edge in
+    // the neighbouring face, the faces become abd and adc, both with a as
+    // their first vertex.  Returns the index of the neighbouring face.
+    int flip(int f, int i)
+    {
+      const Face t = faces_[f];
+      const int g = t.n[i];
+      const Face u = faces_[g];
+      const int j = (u.n[0] == f) ? 0 : ((u.n[1] == f) ? 1 : 2);
+      const int a = t.v[i];
+      const int b = t.v[(i + 1) % 3];
+      const int c = t.v[(i + 2) % 3];
+      const int d = u.v[j];
+      const int t_nb = t.n[(i + 1) % 3];
+      const int t_nc = t.n[(i + 2) % 3];
+      const int u_nb = u.n[(j + 2) % 3];
+      const int u_nc = u.n[(j + 1) % 3];
+      faces_[f] = Face{{a, b, d}, {u_nc, g, t_nc}};
+      faces_[g] = Face{{a, d, c}, {u_nb, t_nb, f}};
+      relink(u_nc, g, f);
+      relink(t_nb, f, g);
+      return g;
+    }
+
+    // Decide whether the edge opposite the vertex with index i in face f
+    // (where that vertex is the newly inserted point) must be flipped.
+    bool must_flip(int f, int i)
+    {
+      const Face& t = faces_[f];
+      const int a = t.v[i];
+      const int b = t.v[(i + 1) % 3];
+      const int c = t.v[(i + 2) % 3];
+      const Face& u = faces_[t.n[i]];
+      const int d = u.v[(u.n[0] == f) ? 0 : ((u.n[1] == f) ? 1 : 2)];
+      if (b == infinite || c == infinite)
+      {
+        // Both faces are ghosts.  The edge to infinity is flipped when
+        // the new point sees the hull edge of the neighbouring ghost,
+        // that is, when the resulting finite face is CCW.
+        return b == infinite ?
+          kernel_.orientation(point(a), point(d), point(c)) ==
+            Kernel::Orientation::left_turn :
+          kernel_.orientation(point(a), point(b), point(d)) ==
+            Kernel::Orientation::left_turn;
+      }
+      if (d == infinite)
+      {
+        // The edge bc is on the convex hull.
+        return false;
+      }
+      // The edge bc has the incident faces cab and cbd.  If d is inside
+      // (or on) the circle through a, b, and c, the quadrilateral abdc is
+      // strictly convex, so no separate convexity test is needed.
+      return !kernel_.is_locally_pd_delaunay_edge(point(c), point(a),
+        point(b), point(d), u_, v_);
+    }
+
+    // Restore the PD-Delaunay property around the new vertex p, given the
+    // faces incident on p.
+    void restore(int p, std::vector<int>& stack)
+    {
+      while (!stack.empty())
+      {
+        const int f = stack.back();
+        stack.pop_back();
+        const int i = index_of(faces_[f], p);
+        if (must_flip(f, i))
+        {
+          const int g = flip(f, i);
+          stack.push_back(f);
+          stack.push_back(g);
+        }
+      }
+    }
+
+    void insert(int p)
+    {
+      Location location;
+      int edge = -1;
+      const int f = locate(point(p), location, edge);
+      if (location == Location::vertex)
+      {
+        // A duplicate of an existing vertex.
+        return;
+      }
+      inserted_[p] = true;
+      const std::array<int, 3> faces = split_face(f, p);
+      std::vector<int> stack(faces.begin(), faces.end());
+      if (location == Location::edge)
+      {
+        // The new face that has the edge containing p is flat.  Flipping
+        // that edge (which is always possible, since p lies strictly
+        // inside it) removes the flat face.
+        const int flat = faces[(edge + 1) % 3];
+        stack.push_back(flip(flat, index_of(faces_[flat], p)));
+      }
+      restore(p, stack);
+      // Flips keep p in f, so start the next walk from a finite face
+      // around p.
+      last_ = find_finite_face_around(f, p);
+    }
+
+    // Find a finite face incident on the vertex p, starting from the face
+    // f which is also incident on p.
+    int find_finite_face_around(int f, int p)
+    {
+      int g = f;
+      do
+      {
+        if (!is_ghost(faces_[g]))
+        {
+          return g;
+        }
+        const Face& face = faces_[g];
+        g = face.n[(index_of(face, p) + 1) % 3];
+      } while (g != f);
+      return f;
+    }
+
+    Kernel kernel_;
+    Vector u_;
+    Vector v_;
+    const std::vector<Point>* points_ = nullptr;
+    std::vector<Face> faces_;
+    std::vector<bool> inserted_;
+    int last_ = 0;
+    std::minstd_rand random_;
+};
+
+}
+
+#endif
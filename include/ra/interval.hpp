@@ -1,9 +1,12 @@
 #ifndef interval_hpp
 #define interval_hpp
 
+#include <cmath>
 #include <iostream>
 #include <string>
 #include <cfenv>
+#include <stdexcept>
+#include <type_traits>
 
 namespace ra
 {
@@ -17,19 +20,29 @@ class rounding_mode_saver {
     // the time of construction.
     ~rounding_mode_saver ()
     {
+      ++change_count_;
       if (std::fesetround(old_mode)) {abort();}
     }
     // The type is neither movable nor copyable.
     
     void round_down()
     {
+      ++change_count_;
       if (std::fesetround(FE_DOWNWARD)) {abort();}
     }
 
     void round_up()
     {
+      ++change_count_;
       if (std::fesetround(FE_UPWARD)) {abort();}      
     }
+
+    // Get the number of calls of std::fesetround made by objects of
+    // this type (in the calling thread).
+    static unsigned long change_count() { return change_count_; }
+
+    // Set the number of calls of std::fesetround to zero.
+    static void clear_change_count() { change_count_ = 0; }
     rounding_mode_saver ( rounding_mode_saver &&) = delete;
     rounding_mode_saver (const rounding_mode_saver &) = delete;
     rounding_mode_saver & operator=( rounding_mode_saver &&) = delete;
@@ -37,13 +50,75 @@ class rounding_mode_saver {
 
     private:
     int old_mode = std::fegetround();
+
+    inline static thread_local unsigned long change_count_ = 0;
 };
 
+// Set the rounding mode to upward for the lifetime of the object.
+// Interval expressions evaluated meanwhile (in the same thread) rely on
+// this and do not change the rounding mode themselves, so that a
+// computation made of many expressions (e.g., a predicate) needs only
+// one change of the rounding mode and one restore.
+class upward_rounding {
+    public:
+    upward_rounding()
+    {
+      rms.round_up();
+      ++depth_;
+    }
+
+    ~upward_rounding() { --depth_; }
+
+    // Tell whether the calling thread is within the lifetime of an
+    // object of this type.
+    static bool active() { return depth_ > 0; }
+
+    upward_rounding(upward_rounding&&) = delete;
+    upward_rounding(const upward_rounding&) = delete;
+    upward_rounding& operator=(upward_rounding&&) = delete;
+    upward_rounding& operator=(const upward_rounding&) = delete;
+
+    private:
+    rounding_mode_saver rms;
+
+    inline static thread_local int depth_ = 0;
+};
+
+// Return x unchanged, but hide its value from the optimizer.
+// Some compilers (notably GCC, even with -frounding-math) evaluate a
+// floating-point operation once for two different rounding modes or move
+// it across a change of the rounding mode.  Passing the operands and the
+// result of each rounded operation through this function prevents that.
+// Floating-point values that are kept in SSE registers are passed
+// through a register, which is much cheaper than the memory round trip
+// needed for other types.
+template <class T>
+inline T opacify(T x)
+{
+#if defined(__GNUC__) && defined(__SSE2_MATH__)
+  if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>)
+  {
+    asm volatile("" : "+x"(x));
+    return x;
+  }
+#endif
+#if defined(__GNUC__)
+  asm volatile("" : "+m"(x));
+#else
+  volatile T y = x;
+  x = y;
+#endif
+  return x;
+}
+
 struct indeterminate_result : public std::runtime_error
 {
   using std::runtime_error::runtime_error;
 };
 
+template <class Operation, class Left, class Right>
+class interval_expression;
+
 // struct statistics {
 // 	// The total number of indeterminate results encountered.
 // 	unsigned long indeterminate_result_count;
@@ -56,11 +131,18 @@ class interval{
   public:
     using real_type = T;
 
+    // The number of arithmetic operations of an interval as an operand
+    // of an interval expression.
+    static constexpr unsigned long operation_count = 0;
+
     struct statistics {
       // The total number of indeterminate results encountered.
       unsigned long indeterminate_result_count ;
       // The total number of interval arithmetic operations.
       unsigned long arithmetic_op_count ;
+      // The total number of changes of the rounding mode (i.e.,
+      // calls of std::fesetround), by intervals of any type.
+      unsigned long rounding_mode_change_count ;
     };
 
 
@@ -84,49 +166,45 @@ class interval{
     
     ~interval() = default;
 
+    // Evaluate the interval expression x (see interval_expression).
+    template <class Operation, class Left, class Right>
+    interval(const interval_expression<Operation, Left, Right>& x)
+    {
+      x.evaluate(lower_bound, upper_bound);
+    }
+
     interval& operator+=(const interval& other)
     { 
-      rounding_mode_saver rms;
-
-      rms.round_down();
-      lower_bound = lower_bound + other.lower_bound;
-      
-      rms.round_up();      
-      upper_bound = upper_bound + other.upper_bound;
-      ++stats_.arithmetic_op_count;
-      return *this;
+      return *this = *this + other;
     }
 
-    //TODO
-    //remember to check what happens if we operate on itself
     interval& operator-=(const interval& other)
     {
-      auto tmp = other.lower_bound;
-      rounding_mode_saver rms;
-
-      rms.round_down();
-
-      lower_bound = lower_bound - other.upper_bound;
-
-      rms.round_up();
-      upper_bound = upper_bound - tmp;
-      ++stats_.arithmetic_op_count;
-      return *this;
+      return *this = *this - other;
     }
 
-    //TODO
-    //remember to check what happens if we operate on itself
     interval& operator*=(const interval& other)
     { 
+      return *this = *this * other;
+    }
+
+    // Division by an interval that contains zero is not defined; in
+    // that case indeterminate_result is thrown and *this is unchanged.
+    interval& operator/=(const interval& other)
+    {
+      if (!(other.lower_bound > 0 || other.upper_bound < 0))
+      {
+        ++stats_.indeterminate_result_count;
+        throw indeterminate_result("Division by an interval containing zero");
+      }
       rounding_mode_saver rms;
 
       rms.round_down();
-      const real_type arr1 [] = {lower_bound*other.lower_bound, lower_bound*other.upper_bound, upper_bound*other.lower_bound, upper_bound*other.upper_bound};      
-      
+      const real_type arr1 [] = {div(lower_bound, other.lower_bound), div(lower_bound, other.upper_bound), div(upper_bound, other.lower_bound), div(upper_bound, other.upper_bound)};
+
       rms.round_up();
-      const real_type arr2 [] = {lower_bound*other.lower_bound, lower_bound*other.upper_bound, upper_bound*other.lower_bound, upper_bound*other.upper_bound};            
-      
-      
+      const real_type arr2 [] = {div(lower_bound, other.lower_bound), div(lower_bound, other.upper_bound), div(upper_bound, other.lower_bound), div(upper_bound, other.upper_bound)};
+
       lower_bound = get_min(arr1);
 
       upper_bound = get_max(arr2);
@@ -174,19 +252,34 @@ class interval{
     {
       stats_.indeterminate_result_count = 0;
       stats_.arithmetic_op_count = 0;
+      rounding_mode_saver::clear_change_count();
     }
 
     static void get_statistics(statistics& stats)
     {
       stats.indeterminate_result_count = stats_.indeterminate_result_count;
       stats.arithmetic_op_count = stats_.arithmetic_op_count;
+      stats.rounding_mode_change_count = rounding_mode_saver::change_count();
     }
 
   private:
     real_type lower_bound;
     real_type upper_bound;
 
-    static statistics stats_;
+    // The statistics are kept per thread.
+    static thread_local statistics stats_;
+
+    // Multiply in the current rounding mode.
+    static real_type mul(real_type a, real_type b)
+    {
+      return opacify(opacify(a) * opacify(b));
+    }
+
+    // Divide in the current rounding mode.
+    static real_type div(real_type a, real_type b)
+    {
+      return opacify(opacify(a) / opacify(b));
+    }
     
     real_type get_min(const real_type * mins)
     {
@@ -218,38 +311,332 @@ class interval{
       return max;
     }
 
+    // Get the negated lower bound and the upper bound, as an operand of
+    // an interval expression.
+    void evaluate_upward(real_type& negated_lower, real_type& upper) const
+    {
+      negated_lower = -lower_bound;
+      upper = upper_bound;
+    }
+
     template <typename R>
     friend bool operator<(const interval<R>&a, const interval<R>& b);
+
+    template <class Operation, class Left, class Right>
+    friend class interval_expression;
 };
 
   template<typename T>
-  typename interval<T>::statistics interval<T>::stats_ = {0,0};
+  thread_local typename interval<T>::statistics interval<T>::stats_ = {0,0,0};
+
+  // Tell whether X is an interval or an interval expression.
+  template <class X>
+  struct is_interval_operand : std::false_type {};
+
+  template <class T>
+  struct is_interval_operand<interval<T>> : std::true_type {};
+
+  template <class Operation, class Left, class Right>
+  struct is_interval_operand<interval_expression<Operation, Left, Right>> :
+    std::true_type {};
+
+  template <class Left, class Right>
+  using enable_if_interval_operands = std::enable_if_t<
+    is_interval_operand<Left>::value && is_interval_operand<Right>::value>;
+
+  // The operations of interval expressions.
+  // Each computes the negated lower bound and the upper bound of its
+  // result from those of its operands, rounding upward (which rounds the
+  // lower bound downward); the rounding mode must be upward.
+  // The additive operations also combine a product a*b with another
+  // operand c (as a*b op c with apply_product_left and as c op a*b with
+  // apply_product_right) without rounding the product (see
+  // interval_times::multiply_add).
+  struct interval_times
+  {
+    template <class T>
+    static void apply(T a_lower, T a_upper, T b_lower, T b_upper,
+      T& lower, T& upper)
+    {
+      // The bounds of the operands (a_lower and b_lower are negated).
+      const T al = -a_lower;
+      const T bl = -b_lower;
+      lower = max(mul(a_lower, bl), mul(a_lower, b_upper), mul(-a_upper, bl),
+        mul(-a_upper, b_upper));
+      upper = max(mul(al, bl), mul(al, b_upper), mul(a_upper, bl),
+        mul(a_upper, b_upper));
+    }
 
-  template<typename T>
-  interval<T> operator+(const interval<T>& a, const interval<T>& b)
-  {   
-      interval<T> tmp(a);
-      tmp.operator+=(b);
-      return tmp;
+    // Compute the bounds of a*b + c with one rounding per bound, by
+    // fused multiply-adds of the endpoints: each endpoint product is
+    // exact within the fused multiply-add, so only the sum is rounded.
+    template <class T>
+    static void multiply_add(T a_lower, T a_upper, T b_lower, T b_upper,
+      T c_lower, T c_upper, T& lower, T& upper)
+    {
+      const T al = -a_lower;
+      const T bl = -b_lower;
+      lower = max(fma(a_lower, bl, c_lower), fma(a_lower, b_upper, c_lower),
+        fma(-a_upper, bl, c_lower), fma(-a_upper, b_upper, c_lower));
+      upper = max(fma(al, bl, c_upper), fma(al, b_upper, c_upper),
+        fma(a_upper, bl, c_upper), fma(a_upper, b_upper, c_upper));
+    }
+
+    private:
+    template <class T>
+    static T mul(T a, T b)
+    {
+      return opacify(opacify(a) * opacify(b));
+    }
+
+    template <class T>
+    static T fma(T a, T b, T c)
+    {
+      return opacify(std::fma(opacify(a), opacify(b), opacify(c)));
+    }
+
+    template <class T>
+    static T max(T a, T b, T c, T d)
+    {
+      const T ab = a > b ? a : b;
+      const T cd = c > d ? c : d;
+      return ab > cd ? ab : cd;
+    }
+  };
+
+  struct interval_plus
+  {
+    template <class T>
+    static void apply(T a_lower, T a_upper, T b_lower, T b_upper,
+      T& lower, T& upper)
+    {
+      lower = opacify(opacify(a_lower) + opacify(b_lower));
+      upper = opacify(opacify(a_upper) + opacify(b_upper));
+    }
+
+    template <class T>
+    static void apply_product_left(T a_lower, T a_upper, T b_lower,
+      T b_upper, T c_lower, T c_upper, T& lower, T& upper)
+    {
+      interval_times::multiply_add(a_lower, a_upper, b_lower, b_upper,
+        c_lower, c_upper, lower, upper);
+    }
+
+    template <class T>
+    static void apply_product_right(T c_lower, T c_upper, T a_lower,
+      T a_upper, T b_lower, T b_upper, T& lower, T& upper)
+    {
+      interval_times::multiply_add(a_lower, a_upper, b_lower, b_upper,
+        c_lower, c_upper, lower, upper);
+    }
+  };
+
+  struct interval_minus
+  {
+    template <class T>
+    static void apply(T a_lower, T a_upper, T b_lower, T b_upper,
+      T& lower, T& upper)
+    {
+      lower = opacify(opacify(a_lower) + opacify(b_upper));
+      upper = opacify(opacify(a_upper) + opacify(b_lower));
+    }
+
+    // a*b - c = a*b + (-c), and -c has the negated bounds of c swapped.
+    template <class T>
+    static void apply_product_left(T a_lower, T a_upper, T b_lower,
+      T b_upper, T c_lower, T c_upper, T& lower, T& upper)
+    {
+      interval_times::multiply_add(a_lower, a_upper, b_lower, b_upper,
+        c_upper, c_lower, lower, upper);
+    }
+
+    // c - a*b = -(a*b - c).
+    template <class T>
+    static void apply_product_right(T c_lower, T c_upper, T a_lower,
+      T a_upper, T b_lower, T b_upper, T& lower, T& upper)
+    {
+      apply_product_left(a_lower, a_upper, b_lower, b_upper, c_lower,
+        c_upper, upper, lower);
+    }
+  };
+
+  // Tell whether X is an interval expression whose last operation is a
+  // multiplication.
+  template <class X>
+  struct is_interval_product : std::false_type {};
+
+  template <class Left, class Right>
+  struct is_interval_product<interval_expression<interval_times, Left,
+    Right>> : std::true_type {};
+
+  // An expression of intervals, built by the binary operators +, -, and
+  // *, and evaluated when it is converted to an interval.
+  // The whole expression (e.g., a*(e*i - f*h) - b*(d*i - f*g)) is
+  // evaluated at once, without intermediate interval objects and with the
+  // rounding mode set to upward only once (or not at all, within the
+  // lifetime of an upward_rounding object); the lower bounds are computed
+  // negated, so that rounding them upward rounds the lower bounds down.
+  // The bounds are the same as those of the operations done one by one,
+  // except in the fused multiply-add mode (if RA_INTERVAL_FMA is
+  // defined), where a product that is an operand of an addition or
+  // subtraction is not rounded (see interval_times::multiply_add), which
+  // gives tighter bounds.  The mode needs hardware support for fused
+  // multiply-adds to be fast (e.g., -mfma).
+  // The operands are held by value (an interval is just two numbers, and
+  // the copies are optimized away), so an expression can outlive the
+  // intervals of which it is made, and does not see later changes to
+  // them.  Each accessor evaluates the whole expression, so an expression
+  // whose bounds are used more than once should be converted to an
+  // interval (e.g., with evaluate) first.
+  template <class Operation, class Left, class Right>
+  class interval_expression
+  {
+    public:
+      using real_type = typename Left::real_type;
+
+      static_assert(std::is_same_v<real_type, typename Right::real_type>,
+        "The operands must have the same real type");
+
+      // The number of interval arithmetic operations of the expression.
+      static constexpr unsigned long operation_count = 1 +
+        Left::operation_count + Right::operation_count;
+
+      interval_expression(const Left& left, const Right& right) :
+        left_(left), right_(right) { }
+
+      // Evaluate the expression.
+      interval<real_type> evaluate() const
+      {
+        return interval<real_type>(*this);
+      }
+
+      real_type lower() const
+      {
+        return evaluate().lower();
+      }
+
+      real_type upper() const
+      {
+        return evaluate().upper();
+      }
+
+      bool is_singleton() const
+      {
+        return evaluate().is_singleton();
+      }
+
+      int sign() const
+      {
+        return evaluate().sign();
+      }
+
+    private:
+      Left left_;
+      Right right_;
+
+      // Get the bounds of the expression; the rounding mode must be
+      // upward.
+      void evaluate_upward(real_type& negated_lower, real_type& upper) const
+      {
+#if defined(RA_INTERVAL_FMA)
+        if constexpr (!std::is_same_v<Operation, interval_times> &&
+          is_interval_product<Left>::value)
+        {
+          real_type a_lower, a_upper, b_lower, b_upper, c_lower, c_upper;
+          left_.left_.evaluate_upward(a_lower, a_upper);
+          left_.right_.evaluate_upward(b_lower, b_upper);
+          right_.evaluate_upward(c_lower, c_upper);
+          Operation::apply_product_left(a_lower, a_upper, b_lower, b_upper,
+            c_lower, c_upper, negated_lower, upper);
+          return;
+        }
+        else if constexpr (!std::is_same_v<Operation, interval_times> &&
+          is_interval_product<Right>::value)
+        {
+          real_type a_lower, a_upper, b_lower, b_upper, c_lower, c_upper;
+          left_.evaluate_upward(c_lower, c_upper);
+          right_.left_.evaluate_upward(a_lower, a_upper);
+          right_.right_.evaluate_upward(b_lower, b_upper);
+          Operation::apply_product_right(c_lower, c_upper, a_lower, a_upper,
+            b_lower, b_upper, negated_lower, upper);
+          return;
+        }
+#endif
+        real_type a_lower, a_upper, b_lower, b_upper;
+        left_.evaluate_upward(a_lower, a_upper);
+        right_.evaluate_upward(b_lower, b_upper);
+        Operation::apply(a_lower, a_upper, b_lower, b_upper, negated_lower,
+          upper);
+      }
+
+      void evaluate(real_type& lower, real_type& upper) const
+      {
+        real_type negated_lower;
+        if (upward_rounding::active())
+        {
+          evaluate_upward(negated_lower, upper);
+        }
+        else
+        {
+          rounding_mode_saver rms;
+          rms.round_up();
+          evaluate_upward(negated_lower, upper);
+        }
+        lower = -negated_lower;
+        interval<real_type>::stats_.arithmetic_op_count += operation_count;
+      }
+
+      template <class O, class L, class R>
+      friend class interval_expression;
+
+      friend class interval<real_type>;
+  };
+
+  template <class Left, class Right,
+    class = enable_if_interval_operands<Left, Right>>
+  interval_expression<interval_plus, Left, Right> operator+(const Left& a,
+    const Right& b)
+  {
+      return {a, b};
   }
 
   //binary minus
-  template<typename T>
-  interval<T> operator-(const interval<T>&a, const interval<T>& b)
+  template <class Left, class Right,
+    class = enable_if_interval_operands<Left, Right>>
+  interval_expression<interval_minus, Left, Right> operator-(const Left& a,
+    const Right& b)
   {
-      interval<T> tmp(a);
-      tmp.operator-=(b);
-      return tmp;
+      return {a, b};
   }
 
   //binary multiply
-  template<typename T>
-  interval<T> operator*(const interval<T>&a, const interval<T>& b)
+  template <class Left, class Right,
+    class = enable_if_interval_operands<Left, Right>>
+  interval_expression<interval_times, Left, Right> operator*(const Left& a,
+    const Right& b)
   {
-      interval<T> tmp(a);
-      tmp.operator*=(b);
+      return {a, b};
+  }
+
+  //binary divide
+  // Division is not part of interval expressions; the operands are
+  // evaluated first.
+  template <class Left, class Right,
+    class = enable_if_interval_operands<Left, Right>>
+  interval<typename Left::real_type> operator/(const Left& a, const Right& b)
+  {
+      interval<typename Left::real_type> tmp(a);
+      tmp.operator/=(b);
       return tmp;
   }
+
+  // Get the reciprocal of the interval a.
+  // If a contains zero, indeterminate_result is thrown.
+  template<typename T>
+  interval<T> reciprocal(const interval<T>& a)
+  {
+      return interval<T>(T(1)) / a;
+  }
   
   //less than
   template<typename T>
@@ -270,6 +657,15 @@ class interval{
     }
   }
 
+  // Interval expressions are evaluated first.
+  template <class Left, class Right,
+    class = enable_if_interval_operands<Left, Right>>
+  bool operator<(const Left& a, const Right& b)
+  {
+    using T = typename Left::real_type;
+    return interval<T>(a) < interval<T>(b);
+  }
+
   // template <typename T> 
   // std::string tostring(const T& number)
   // {
@@ -285,6 +681,13 @@ class interval{
       os << "[" << std::to_string(i.lower()) << "," << std::to_string(i.upper()) << "]";
       return os;
   }
+
+  template <class Operation, class Left, class Right>
+  std::ostream& operator<<(std::ostream& os,
+    const interval_expression<Operation, Left, Right>& e)
+  {
+      return os << e.evaluate();
+  }
 }
 }
 #endif
\ No newline at end of file
@@ -1,9 +1,19 @@
 #ifndef kernel_hpp
 #define kernel_hpp
 
+#include "double_double.hpp"
 #include "interval.hpp"
+#include "latency_histogram.hpp"
+#include "lazy_exact.hpp"
 #include <CGAL/MP_Float.h>
 #include <CGAL/Cartesian.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <ostream>
+#include <utility>
 
 namespace ra::geometry{
 
@@ -20,6 +30,9 @@ class Kernel
     using Point = typename CGAL::Cartesian<R>::Point_2 ;
     // The type used to represent vectors in two dimensions.
     using Vector = typename CGAL::Cartesian<R>::Vector_2 ;
+    // The type used to represent points in two dimensions whose
+    // coordinates are (lazily evaluated) results of computations.
+    using Lazy_point = typename CGAL::Cartesian<lazy_exact<R>>::Point_2 ;
     // The possible outcomes of an orientation test.
     
     enum class Orientation : int {
@@ -33,24 +46,85 @@ class Kernel
     on_negative_side = -1,
     on_boundary = 0,
     on_positive_side = 1,
+    };
+    // The latencies (in nanoseconds) of the stages of a predicate
+    // or construction: the integer stage (which replaces the others
+    // for small integer coordinates), the interval stage, the
+    // double-double stage, and the exact stage (a failed stage
+    // includes the time to throw and catch its exception).  They are
+    // only recorded if RA_KERNEL_PROFILING is defined; otherwise this
+    // type is empty.
+    struct Latencies {
+#ifdef RA_KERNEL_PROFILING
+    latency_histogram integer_stage ;
+    latency_histogram interval_stage ;
+    latency_histogram double_double_stage ;
+    latency_histogram exact_stage ;
+#endif
     };
     // The set of statistics maintained by the kernel.
+    // The statistics are kept per thread: each thread sees only the
+    // tests made by itself (see accumulate_statistics).
     struct Statistics {
     // The total number of orientation tests.
     std::size_t orientation_total_count ;
+    // The number of orientation tests evaluated with integer
+    // arithmetic.
+    std::size_t orientation_integer_count ;
+    // The number of orientation tests requiring double-double
+    // (or exact) arithmetic.
+    std::size_t orientation_double_double_count ;
     // The number of orientation tests requiring exact
     // arithmetic.
     std::size_t orientation_exact_count ;
     // The total number of preferred-direction tests.
     std::size_t preferred_direction_total_count ;
+    // The number of preferred-direction tests evaluated with
+    // integer arithmetic.
+    std::size_t preferred_direction_integer_count ;
+    // The number of preferred-direction tests requiring
+    // double-double (or exact) arithmetic.
+    std::size_t preferred_direction_double_double_count ;
     // The number of preferred-direction tests requiring
     // exact arithmetic.
     std::size_t preferred_direction_exact_count ;
     // The total number of side-of-oriented-circle tests.
     std::size_t side_of_oriented_circle_total_count ;
+    // The number of side-of-oriented-circle tests evaluated with
+    // integer arithmetic.
+    std::size_t side_of_oriented_circle_integer_count ;
+    // The number of side-of-oriented-circle tests requiring
+    // double-double (or exact) arithmetic.
+    std::size_t side_of_oriented_circle_double_double_count ;
     // The number of side-of-oriented-circle tests
     // requiring exact arithmetic.
     std::size_t side_of_oriented_circle_exact_count ;
+    // The total number of circumcenter constructions.
+    std::size_t circumcenter_total_count ;
+    // The number of circumcenter constructions requiring
+    // exact arithmetic.
+    std::size_t circumcenter_exact_count ;
+    // The number of changes of the rounding mode (i.e., calls of
+    // std::fesetround) made by interval arithmetic.
+    std::size_t rounding_mode_change_count ;
+    // The number of exceptions thrown by interval arithmetic on
+    // Real and by double-double arithmetic (i.e., of computations
+    // that could not determine a sign).
+    std::size_t exception_count ;
+    // The latencies of the stages of each predicate and
+    // construction.
+    Latencies orientation_latencies ;
+    Latencies preferred_direction_latencies ;
+    Latencies side_of_oriented_circle_latencies ;
+    Latencies circumcenter_latencies ;
+    };
+    // A point computed by a filtered construction, along with
+    // bounds on its error: the exact result lies within x_error
+    // of point.x() and within y_error of point.y().
+    struct Approximate_point {
+    Point point ;
+    Real x_error ;
+    Real y_error ;
     };
     // Since a kernel object is stateless, construction and
     // destruction are trivial.
@@ -65,38 +139,103 @@ class Kernel
     Kernel& operator=(Kernel&&)= default;
     // Determines how the point c is positioned relative to the
     // directed line through the points a and b (in that order).
+    // If all coordinates are integers of magnitude less than 2^26,
+    // the test is evaluated exactly with integer arithmetic;
+    // otherwise it is filtered (see filtered).
     // Precondition: The points a and b have distinct values.
     Orientation orientation (const Point & a , const Point & b ,
     const Point & c )
     {
       ++(stats_.orientation_total_count);
+      if (are_small_integers({a.x(), a.y(), b.x(), b.y(), c.x(), c.y()}))
+      {
+        return integer_stage([&] {
+          return convert_orientation(orientation_integer(a,b,c));
+        }, stats_.orientation_integer_count, stats_.orientation_latencies);
+      }
+      return filtered([&](auto number) {
+        return orientation_calc<decltype(number)>(a,b,c);
+      }, stats_.orientation_double_double_count,
+        stats_.orientation_exact_count, stats_.orientation_latencies);
+    }
+    // Determines how the point c is positioned relative to the
+    // directed line through the points a and b (in that order).
+    // The determinant is evaluated exactly only if its interval
+    // approximation does not determine the sign.
+    // Precondition: The points a and b have distinct values.
+    Orientation orientation (const Lazy_point & a ,
+    const Lazy_point & b , const Lazy_point & c )
+    {
+      ++(stats_.orientation_total_count);
+      Stage_timer timer(stats_.orientation_latencies);
+      const auto det = orientation_det<lazy_exact<Real>>(a,b,c);
       try
       {
-        return orientation_calc<interval<Real>>(a,b,c);
+        const Orientation result = convert_orientation(det.approx().sign());
+        timer.interval_stage_done();
+        return result;
       }
       catch(indeterminate_result& e)
       {
+        timer.interval_stage_done();
         ++(stats_.orientation_exact_count);
-        return orientation_calc<CGAL::MP_Float>(a,b,c);
+        const Orientation result = convert_orientation(
+          int(det.exact().sign()));
+        timer.exact_stage_done();
+        return result;
       }
     }
     // Determines how the point d is positioned relative to the
     // oriented circle passing through the points a, b, and c
     // (in that order).
+    // As for orientation, small integer coordinates are handled
+    // with integer arithmetic.
     // Precondition: The points a, b, and c are not collinear.
     Oriented_side side_of_oriented_circle (const Point & a ,
     const Point & b , const Point & c , const Point & d )
     {
        ++(stats_.side_of_oriented_circle_total_count);
+      if (are_small_integers({a.x(), a.y(), b.x(), b.y(), c.x(), c.y(),
+        d.x(), d.y()}))
+      {
+        return integer_stage([&] {
+          return convert_oriented_side(circle_side_integer(a,b,c,d));
+        }, stats_.side_of_oriented_circle_integer_count,
+          stats_.side_of_oriented_circle_latencies);
+      }
+      return filtered([&](auto number) {
+        return circle_side_calc<decltype(number)>(a,b,c,d);
+      }, stats_.side_of_oriented_circle_double_double_count,
+        stats_.side_of_oriented_circle_exact_count,
+        stats_.side_of_oriented_circle_latencies);
+    }
+    // Determines how the point d is positioned relative to the
+    // oriented circle passing through the points a, b, and c
+    // (in that order).
+    // The determinant is evaluated exactly only if its interval
+    // approximation does not determine the sign.
+    // Precondition: The points a, b, and c are not collinear.
+    Oriented_side side_of_oriented_circle (const Lazy_point & a ,
+    const Lazy_point & b , const Lazy_point & c , const Lazy_point & d )
+    {
+      ++(stats_.side_of_oriented_circle_total_count);
+      Stage_timer timer(stats_.side_of_oriented_circle_latencies);
+      const auto det = circle_side_det<lazy_exact<Real>>(a,b,c,d);
       try
       {
-        return circle_side_calc<interval<Real>>(a,b,c,d);
+        const Oriented_side result = convert_oriented_side(
+          det.approx().sign());
+        timer.interval_stage_done();
+        return result;
       }
       catch(indeterminate_result& e)
       {
-        // std::cout << "Youa re here" << std::endl;
+        timer.interval_stage_done();
         ++(stats_.side_of_oriented_circle_exact_count);
-        return circle_side_calc<CGAL::MP_Float>(a,b,c,d);
+        const Oriented_side result = convert_oriented_side(
+          int(det.exact().sign()));
+        timer.exact_stage_done();
+        return result;
       }
     }
     // Determines if, compared to the orientation of line
@@ -107,6 +246,8 @@ class Kernel
     // orientation of cd, the orientation of ab is more close,
     // equally close, or less close to the orientation of v,
     // respectively.
+    // As for orientation, small integer coordinates (of the points
+    // and of v) are handled with integer arithmetic.
     // Precondition: The points a and b have distinct values; the
     // points c and d have distinct values; the vector v is not
     // the zero vector.
@@ -114,15 +255,19 @@ class Kernel
     const Point & c , const Point & d , const Vector & v )
     {
        ++(stats_.preferred_direction_total_count);
-      try
+      if (are_small_integers({a.x(), a.y(), b.x(), b.y(), c.x(), c.y(),
+        d.x(), d.y(), v.x(), v.y()}))
       {
-        return preferred_dir<interval<Real>>(a,b,c,d,v);
-      }
-      catch(indeterminate_result& e)
-      {
-        ++(stats_.preferred_direction_exact_count);
-        return preferred_dir<CGAL::MP_Float>(a,b,c,d,v);
+        return integer_stage([&] {
+          return preferred_dir_integer(a,b,c,d,v);
+        }, stats_.preferred_direction_integer_count,
+          stats_.preferred_direction_latencies);
       }
+      return filtered([&](auto number) {
+        return preferred_dir<decltype(number)>(a,b,c,d,v);
+      }, stats_.preferred_direction_double_double_count,
+        stats_.preferred_direction_exact_count,
+        stats_.preferred_direction_latencies);
     }
     // Tests if the quadrilateral with vertices a, b, c, and d
     // specified in CCW order is strictly convex.
@@ -165,51 +310,417 @@ class Kernel
     const Point & b , const Point & c , const Point & d ,
     const Vector & u , const Vector & v )
     {
-      int val;
-      if (side_of_oriented_circle(a,b,c,d) == Oriented_side::on_negative_side)
+      const Oriented_side side = side_of_oriented_circle(a,b,c,d);
+      if (side != Oriented_side::on_boundary)
       {
-        val = 1;
-      } else if(side_of_oriented_circle(a,b,c,d) == Oriented_side::on_positive_side)
+        return side == Oriented_side::on_negative_side;
+      }
+      // The points are cocircular, so the tie is broken by comparing the
+      // two diagonals ac and bd against the preferred directions.
+      const int pd_u = preferred_direction(a,c,b,d,u);
+      return pd_u > 0 || (pd_u == 0 && preferred_direction(a,c,b,d,v) > 0);
+    }
+    // Computes the center of the circle passing through the
+    // points a, b, and c, with certified bounds on its error.
+    // Precondition: The points a, b, and c are not collinear.
+    Approximate_point circumcenter (const Point & a ,
+    const Point & b , const Point & c )
+    {
+      ++(stats_.circumcenter_total_count);
+      Stage_timer timer(stats_.circumcenter_latencies);
+      interval<Real> x;
+      interval<Real> y;
+      try
       {
-        val = 0;
-      } else{
-        if(preferred_direction(b,c,a,d,u) > 0 || (preferred_direction(b,c,a,d,u) == 0 && preferred_direction(b,c,a,d,v) > 0))
-        {
-          val = 1;
-        }
-        else{
-          val = 0;
-        }
+        interval<Real> x_num, y_num, den;
+        circumcenter_calc<interval<Real>>(a,b,c,x_num,y_num,den);
+        x = interval<Real>(c.x()) + x_num / den;
+        y = interval<Real>(c.y()) + y_num / den;
+        timer.interval_stage_done();
       }
-
-      return val == 1;
+      catch(indeterminate_result& e)
+      {
+        timer.interval_stage_done();
+        // The denominator is too close to zero for the filter, so
+        // the terms are computed exactly and only then rounded.
+        ++(stats_.circumcenter_exact_count);
+        CGAL::MP_Float x_num, y_num, den;
+        circumcenter_calc<CGAL::MP_Float>(a,b,c,x_num,y_num,den);
+        x = interval<Real>(c.x()) + to_interval(x_num) / to_interval(den);
+        y = interval<Real>(c.y()) + to_interval(y_num) / to_interval(den);
+        timer.exact_stage_done();
+      }
+      Approximate_point result;
+      Real px, py;
+      approximate(x, px, result.x_error);
+      approximate(y, py, result.y_error);
+      result.point = Point(px, py);
+      return result;
     }
     // Clear (i.e., set to zero) all kernel statistics.
+    // This also clears the statistics of interval<Real> and
+    // double_double, from which the rounding-mode-change and
+    // exception counts are taken.
     static void clear_statistics ()
     {
       stats_.orientation_total_count = 0;
+      stats_.orientation_integer_count = 0;
+      stats_.orientation_double_double_count = 0;
       stats_.orientation_exact_count = 0;
       stats_.preferred_direction_total_count = 0;
+      stats_.preferred_direction_integer_count = 0;
+      stats_.preferred_direction_double_double_count = 0;
       stats_.preferred_direction_exact_count = 0;
       stats_.side_of_oriented_circle_total_count = 0;
+      stats_.side_of_oriented_circle_integer_count = 0;
+      stats_.side_of_oriented_circle_double_double_count = 0;
       stats_.side_of_oriented_circle_exact_count = 0;
+      stats_.circumcenter_total_count = 0;
+      stats_.circumcenter_exact_count = 0;
+      stats_.orientation_latencies = Latencies();
+      stats_.preferred_direction_latencies = Latencies();
+      stats_.side_of_oriented_circle_latencies = Latencies();
+      stats_.circumcenter_latencies = Latencies();
+      interval<Real>::clear_statistics();
+      double_double::clear_statistics();
     }
     // Get the current values of the kernel statistics.
     static void get_statistics ( Statistics & statistics )
     {
       statistics.orientation_total_count = stats_.orientation_total_count;
+      statistics.orientation_integer_count = stats_.orientation_integer_count;
+      statistics.orientation_double_double_count = stats_.orientation_double_double_count;
       statistics.orientation_exact_count = stats_.orientation_exact_count;
       statistics.preferred_direction_total_count = stats_.preferred_direction_total_count;
+      statistics.preferred_direction_integer_count = stats_.preferred_direction_integer_count;
+      statistics.preferred_direction_double_double_count = stats_.preferred_direction_double_double_count;
       statistics.preferred_direction_exact_count = stats_.preferred_direction_exact_count;
       statistics.side_of_oriented_circle_total_count = stats_.side_of_oriented_circle_total_count;
+      statistics.side_of_oriented_circle_integer_count = stats_.side_of_oriented_circle_integer_count;
+      statistics.side_of_oriented_circle_double_double_count = stats_.side_of_oriented_circle_double_double_count;
       statistics.side_of_oriented_circle_exact_count = stats_.side_of_oriented_circle_exact_count;
+      statistics.circumcenter_total_count = stats_.circumcenter_total_count;
+      statistics.circumcenter_exact_count = stats_.circumcenter_exact_count;
+      typename interval<Real>::statistics interval_statistics;
+      interval<Real>::get_statistics(interval_statistics);
+      statistics.rounding_mode_change_count = interval_statistics.rounding_mode_change_count;
+      double_double::statistics double_double_statistics;
+      double_double::get_statistics(double_double_statistics);
+      statistics.exception_count = interval_statistics.indeterminate_result_count +
+        double_double_statistics.indeterminate_result_count;
+      statistics.orientation_latencies = stats_.orientation_latencies;
+      statistics.preferred_direction_latencies = stats_.preferred_direction_latencies;
+      statistics.side_of_oriented_circle_latencies = stats_.side_of_oriented_circle_latencies;
+      statistics.circumcenter_latencies = stats_.circumcenter_latencies;
+    }
+    // Add the statistics (e.g., those of another thread) to total.
+    static void accumulate_statistics ( Statistics & total ,
+    const Statistics & statistics )
+    {
+      total.orientation_total_count += statistics.orientation_total_count;
+      total.orientation_integer_count += statistics.orientation_integer_count;
+      total.orientation_double_double_count += statistics.orientation_double_double_count;
+      total.orientation_exact_count += statistics.orientation_exact_count;
+      total.preferred_direction_total_count += statistics.preferred_direction_total_count;
+      total.preferred_direction_integer_count += statistics.preferred_direction_integer_count;
+      total.preferred_direction_double_double_count += statistics.preferred_direction_double_double_count;
+      total.preferred_direction_exact_count += statistics.preferred_direction_exact_count;
+      total.side_of_oriented_circle_total_count += statistics.side_of_oriented_circle_total_count;
+      total.side_of_oriented_circle_integer_count += statistics.side_of_oriented_circle_integer_count;
+      total.side_of_oriented_circle_double_double_count += statistics.side_of_oriented_circle_double_double_count;
+      total.side_of_oriented_circle_exact_count += statistics.side_of_oriented_circle_exact_count;
+      total.circumcenter_total_count += statistics.circumcenter_total_count;
+      total.circumcenter_exact_count += statistics.circumcenter_exact_count;
+      total.rounding_mode_change_count += statistics.rounding_mode_change_count;
+      total.exception_count += statistics.exception_count;
+      accumulate_latencies(total.orientation_latencies, statistics.orientation_latencies);
+      accumulate_latencies(total.preferred_direction_latencies, statistics.preferred_direction_latencies);
+      accumulate_latencies(total.side_of_oriented_circle_latencies, statistics.side_of_oriented_circle_latencies);
+      accumulate_latencies(total.circumcenter_latencies, statistics.circumcenter_latencies);
+    }
+    // Write the statistics to out as a JSON object.  The latencies
+    // are only included if they are recorded.
+    static void write_statistics_json ( const Statistics & statistics ,
+    std::ostream & out )
+    {
+      out << "{\n";
+      write_json_entry(out, "orientation", statistics.orientation_total_count,
+        statistics.orientation_integer_count,
+        statistics.orientation_double_double_count,
+        statistics.orientation_exact_count, statistics.orientation_latencies);
+      write_json_entry(out, "preferred_direction",
+        statistics.preferred_direction_total_count,
+        statistics.preferred_direction_integer_count,
+        statistics.preferred_direction_double_double_count,
+        statistics.preferred_direction_exact_count,
+        statistics.preferred_direction_latencies);
+      write_json_entry(out, "side_of_oriented_circle",
+        statistics.side_of_oriented_circle_total_count,
+        statistics.side_of_oriented_circle_integer_count,
+        statistics.side_of_oriented_circle_double_double_count,
+        statistics.side_of_oriented_circle_exact_count,
+        statistics.side_of_oriented_circle_latencies);
+      // Circumcenters have no integer or double-double stage.
+      write_json_entry(out, "circumcenter", statistics.circumcenter_total_count,
+        0, statistics.circumcenter_exact_count, statistics.circumcenter_exact_count,
+        statistics.circumcenter_latencies);
+      out << "  \"rounding_mode_changes\": "
+        << statistics.rounding_mode_change_count << ",\n"
+        << "  \"exceptions\": " << statistics.exception_count << "\n}\n";
     }
 
     private:
-    static Statistics stats_;
-    
+    static thread_local Statistics stats_;
+
+#ifdef __SIZEOF_INT128__
+    // An integer type wide enough for the side-of-oriented-circle
+    // determinant of points with coordinates of magnitude less than
+    // 2^26 (which needs 113 bits).
+    __extension__ using Wide_int = __int128;
+    __extension__ using Wide_uint = unsigned __int128;
+    static constexpr bool has_integer_stage = true;
+#else
+    using Wide_int = std::int64_t;
+    using Wide_uint = std::uint64_t;
+    static constexpr bool has_integer_stage = false;
+#endif
+
+    // Tests if the values are all integers of magnitude less than 2^26
+    // (and the integer stage is available).
+    static bool are_small_integers ( std::initializer_list<Real> values )
+    {
+      if (!has_integer_stage)
+      {
+        return false;
+      }
+      for (Real x : values)
+      {
+        if (!(std::abs(x) < Real(1 << 26) && Real(std::int64_t(x)) == x))
+        {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    // Evaluate a predicate with calc, which uses integer arithmetic,
+    // counting it and recording its latency.
+    template <class F>
+    auto integer_stage ( F calc , std::size_t & integer_count ,
+    Latencies & latencies )
+    {
+      Stage_timer timer(latencies);
+      ++integer_count;
+      const auto result = calc();
+      timer.integer_stage_done();
+      return result;
+    }
+
+    template <class T>
+    static int sign_of(T x)
+    {
+      return (x > 0) - (x < 0);
+    }
+
+    // The integer versions of the predicates.
+    // Precondition: All coordinates are integers of magnitude less than
+    // 2^26, so that differences take 27 bits, the orientation
+    // determinant 55 bits, and the side-of-oriented-circle determinant
+    // 113 bits.
+    int orientation_integer(const Point &a, const Point &b, const Point &c)
+    {
+      const std::int64_t xa(a.x()), ya(a.y()), xb(b.x()), yb(b.y()),
+        xc(c.x()), yc(c.y());
+      return sign_of((xa - xc) * (yb - yc) - (xb - xc) * (ya - yc));
+    }
+
+    int circle_side_integer(const Point &a, const Point &b, const Point &c,
+      const Point &d)
+    {
+      // The determinant of circle_side_det, with the points translated
+      // so that d is the origin (which does not change it).
+      const std::int64_t xd(d.x()), yd(d.y());
+      const std::int64_t adx = std::int64_t(a.x()) - xd;
+      const std::int64_t ady = std::int64_t(a.y()) - yd;
+      const std::int64_t bdx = std::int64_t(b.x()) - xd;
+      const std::int64_t bdy = std::int64_t(b.y()) - yd;
+      const std::int64_t cdx = std::int64_t(c.x()) - xd;
+      const std::int64_t cdy = std::int64_t(c.y()) - yd;
+      const Wide_int alift = adx * adx + ady * ady;
+      const Wide_int blift = bdx * bdx + bdy * bdy;
+      const Wide_int clift = cdx * cdx + cdy * cdy;
+      return sign_of(adx * (bdy * clift - cdy * blift) -
+        bdx * (ady * clift - cdy * alift) +
+        cdx * (ady * blift - bdy * alift));
+    }
+
+    int preferred_dir_integer(const Point &a, const Point &b,
+      const Point &c, const Point &d, const Vector &v)
+    {
+      // The sign of |d - c|^2 ((b - a).v)^2 - |b - a|^2 ((d - c).v)^2.
+      // Each term is the product of a 55-bit and a 108-bit factor, so the
+      // terms are compared as 192-bit numbers.
+      const std::int64_t bax = std::int64_t(b.x()) - std::int64_t(a.x());
+      const std::int64_t bay = std::int64_t(b.y()) - std::int64_t(a.y());
+      const std::int64_t dcx = std::int64_t(d.x()) - std::int64_t(c.x());
+      const std::int64_t dcy = std::int64_t(d.y()) - std::int64_t(c.y());
+      const std::int64_t vx(v.x()), vy(v.y());
+      const std::uint64_t ba_2 = std::uint64_t(bax * bax + bay * bay);
+      const std::uint64_t dc_2 = std::uint64_t(dcx * dcx + dcy * dcy);
+      const Wide_int ba_v = bax * vx + bay * vy;
+      const Wide_int dc_v = dcx * vx + dcy * vy;
+      const auto left = multiply_wide(dc_2, Wide_uint(ba_v * ba_v));
+      const auto right = multiply_wide(ba_2, Wide_uint(dc_v * dc_v));
+      return (left > right) - (left < right);
+    }
+
+    // Get the product of x and y as a pair of the high bits and the low
+    // 64 bits.
+    static std::pair<Wide_uint, std::uint64_t> multiply_wide(std::uint64_t x,
+      Wide_uint y)
+    {
+      const Wide_uint low = Wide_uint(x) * std::uint64_t(y);
+      // (The shift is split so that it is valid for any Wide_uint.)
+      const Wide_uint high = Wide_uint(x) * std::uint64_t(y >> 32 >> 32);
+      return {high + (low >> 64), std::uint64_t(low)};
+    }
+
+    // The double-double stage only starts from exact values if Real is
+    // no wider than double.
+    static constexpr bool has_double_double_stage =
+      std::numeric_limits<Real>::digits <= std::numeric_limits<double>::digits;
+
+    // Evaluate a predicate in stages: with interval arithmetic, then (if
+    // the interval cannot decide) with double-double arithmetic, and
+    // finally with exact arithmetic, where calc(T()) evaluates the
+    // predicate with the number type T and throws indeterminate_result
+    // if T cannot decide.  The counts of the calls that needed the
+    // later stages are incremented, and the stage latencies recorded.
+    template <class F>
+    auto filtered ( F calc , std::size_t & double_double_count ,
+    std::size_t & exact_count , Latencies & latencies )
+    {
+      Stage_timer timer(latencies);
+      try
+      {
+        const auto result = calc(interval<Real>());
+        timer.interval_stage_done();
+        return result;
+      }
+      catch(indeterminate_result& e)
+      {
+        timer.interval_stage_done();
+      }
+      ++double_double_count;
+      if constexpr (has_double_double_stage)
+      {
+        try
+        {
+          const auto result = calc(double_double());
+          timer.double_double_stage_done();
+          return result;
+        }
+        catch(indeterminate_result& e)
+        {
+          timer.double_double_stage_done();
+        }
+      }
+      ++exact_count;
+      const auto result = calc(CGAL::MP_Float());
+      timer.exact_stage_done();
+      return result;
+    }
+
+    static void accumulate_latencies ( Latencies & total ,
+    const Latencies & latencies )
+    {
+#ifdef RA_KERNEL_PROFILING
+      total.integer_stage.add(latencies.integer_stage);
+      total.interval_stage.add(latencies.interval_stage);
+      total.double_double_stage.add(latencies.double_double_stage);
+      total.exact_stage.add(latencies.exact_stage);
+#else
+      static_cast<void>(total);
+      static_cast<void>(latencies);
+#endif
+    }
+
+    // Records the latencies of the stages of one predicate or
+    // construction (if RA_KERNEL_PROFILING is defined).
+    class Stage_timer {
+      public:
+#ifdef RA_KERNEL_PROFILING
+      Stage_timer(Latencies & latencies) : latencies_(latencies) {}
+      void integer_stage_done() { watch_.record(latencies_.integer_stage); }
+      void interval_stage_done() { watch_.record(latencies_.interval_stage); }
+      void double_double_stage_done() { watch_.record(latencies_.double_double_stage); }
+      void exact_stage_done() { watch_.record(latencies_.exact_stage); }
+
+      private:
+      Latencies & latencies_;
+      stopwatch watch_;
+#else
+      Stage_timer(Latencies &) {}
+      void integer_stage_done() {}
+      void interval_stage_done() {}
+      void double_double_stage_done() {}
+      void exact_stage_done() {}
+#endif
+    };
+
+    static void write_json_entry ( std::ostream & out , const char * name ,
+    std::size_t total_count , std::size_t integer_count ,
+    std::size_t double_double_count , std::size_t exact_count ,
+    const Latencies & latencies )
+    {
+      out << "  \"" << name << "\": {\"total\": " << total_count
+        << ", \"integer\": " << integer_count
+        << ", \"double_double\": " << double_double_count
+        << ", \"exact\": " << exact_count;
+#ifdef RA_KERNEL_PROFILING
+      out << ",\n    \"integer_stage_ns\": ";
+      latencies.integer_stage.write_json(out);
+      out << ",\n    \"interval_stage_ns\": ";
+      latencies.interval_stage.write_json(out);
+      out << ",\n    \"double_double_stage_ns\": ";
+      latencies.double_double_stage.write_json(out);
+      out << ",\n    \"exact_stage_ns\": ";
+      latencies.exact_stage.write_json(out);
+#else
+      static_cast<void>(latencies);
+#endif
+      out << "},\n";
+    }
+
+    // Evaluate calc() with the rounding mode set to upward once if T is
+    // an interval type, so that its interval expressions need not change
+    // it (see upward_rounding).
+    // Precondition: calc does no arithmetic on Real itself (which would
+    // be rounded upward too); e.g., it only converts coordinates to T.
+    template <class T, class F>
+    static auto with_rounding_for(F calc)
+    {
+      if constexpr (std::is_same_v<T, interval<Real>>)
+      {
+        upward_rounding rounding;
+        return calc();
+      }
+      else
+      {
+        return calc();
+      }
+    }
+
     template<class T>
     Orientation orientation_calc(const Point &a, const Point &b, const Point &c)
+    {
+      return with_rounding_for<T>([&] {
+        return convert_orientation(orientation_det<T>(a,b,c).sign());
+      });
+    }
+
+    template<class T, class P>
+    T orientation_det(const P &a, const P &b, const P &c)
     {
       T xa(a.x());
       T ya(a.y());
@@ -224,8 +735,7 @@ class Kernel
       T fourth(yb - yc);
 
       T det = (first * fourth) - (second * third);
-      return convert_orientation(det.sign());
-      
+      return det;
     }
 
     Orientation convert_orientation(int s)
@@ -260,18 +770,28 @@ class Kernel
       }
     }
 
-    template <class T>
-    typename CGAL::Cartesian<T>::Point_3 make_3d_point(const Point& pt)
+    template <class T, class P>
+    typename CGAL::Cartesian<T>::Point_3 make_3d_point(const P& pt)
     {
       T x_(pt.x());
       T y_(pt.y());
 
-      typename CGAL::Cartesian<T>::Point_3 p(x_, y_, (x_ * x_) + (y_ * y_));
+      T z_((x_ * x_) + (y_ * y_));
+
+      typename CGAL::Cartesian<T>::Point_3 p(x_, y_, z_);
       return p;
     }
 
     template<class T>
     Oriented_side circle_side_calc(const Point &a, const Point &b, const Point &c, const Point& d)
+    {
+      return with_rounding_for<T>([&] {
+        return convert_oriented_side(circle_side_det<T>(a,b,c,d).sign());
+      });
+    }
+
+    template<class T, class P>
+    T circle_side_det(const P &a, const P &b, const P &c, const P& d)
     {
       auto aa  = make_3d_point<T>(a);
       auto bb =  make_3d_point<T>(b);
@@ -291,7 +811,7 @@ class Kernel
       T det = determinants_3d(e1,e2,e3,e4,e5,e6,e7,e8,e9);
       // std::cout << det << std::endl;
       // std::cout << "****************" << std::endl;
-      return convert_oriented_side(det.sign());
+      return det;
     }
 
     template <class T>
@@ -319,6 +839,60 @@ class Kernel
       return pt;
     }
 
+    // Computes the circumcenter of a, b, and c relative to c as
+    // (x_num / den, y_num / den).
+    template <class T>
+    void circumcenter_calc(const Point & a , const Point & b , const Point & c , T & x_num , T & y_num , T & den )
+    {
+      T xa(a.x());
+      T ya(a.y());
+      T xb(b.x());
+      T yb(b.y());
+      T xc(c.x());
+      T yc(c.y());
+
+      T first(xa - xc);
+      T second(ya - yc);
+      T third(xb - xc);
+      T fourth(yb - yc);
+
+      T a_2 = (first * first) + (second * second);
+      T b_2 = (third * third) + (fourth * fourth);
+      T det = (first * fourth) - (second * third);
+
+      x_num = (fourth * a_2) - (second * b_2);
+      y_num = (first * b_2) - (third * a_2);
+      den = det + det;
+    }
+
+    // Get an interval of type Real that contains the value x.
+    interval<Real> to_interval(const CGAL::MP_Float & x)
+    {
+      const std::pair<double, double> bounds = CGAL::to_interval(x);
+      Real lower(bounds.first);
+      Real upper(bounds.second);
+      if (lower > bounds.first)
+      {
+        lower = std::nextafter(lower, -std::numeric_limits<Real>::infinity());
+      }
+      if (upper < bounds.second)
+      {
+        upper = std::nextafter(upper, std::numeric_limits<Real>::infinity());
+      }
+      return interval<Real>(lower, upper);
+    }
+
+    // Get the midpoint of x and (rounded up) the largest distance from
+    // it to an endpoint of x.
+    void approximate(const interval<Real> & x , Real & value , Real & error )
+    {
+      value = x.lower() + (x.upper() - x.lower()) / 2;
+      rounding_mode_saver rms;
+      rms.round_up();
+      error = std::max(opacify(opacify(value) - opacify(x.lower())),
+        opacify(opacify(x.upper()) - opacify(value)));
+    }
+
     template <class T>
     int preferred_dir(const Point & a , const Point & b , const Point & c , const Point & d , const Vector & v )
     {
@@ -344,7 +918,7 @@ class Kernel
 
 };
     template<typename T>
-    typename Kernel<T>::Statistics Kernel<T>::stats_ = {0,0,0,0,0,0};
+    thread_local typename Kernel<T>::Statistics Kernel<T>::stats_ = {};
 }
 
 #endif
\ No newline at end of file
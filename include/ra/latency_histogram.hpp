@@ -0,0 +1,164 @@
+#ifndef latency_histogram_hpp
+#define latency_histogram_hpp
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+
+namespace ra
+{
+namespace math {
+
+// A histogram of latencies (in nanoseconds) in the style of HdrHistogram.
+// Values are grouped by their binary order of magnitude, and each group is
+// split linearly into 2^sub_bucket_bits buckets.  So every value is
+// recorded with a relative error of at most 2^-sub_bucket_bits, the
+// histogram has a fixed (small) size, and recording a value takes only a
+// few instructions.
+class latency_histogram {
+  public:
+    // The number of bits of each value that are kept.
+    static constexpr int sub_bucket_bits = 3;
+
+    latency_histogram() { clear(); }
+
+    // Record the value.
+    void record(std::uint64_t value)
+    {
+      ++counts_[index(value)];
+      ++count_;
+      sum_ += value;
+      max_ = std::max(max_, value);
+    }
+
+    // Record all the values recorded by other.
+    void add(const latency_histogram& other)
+    {
+      for (int i = 0; i < bucket_count; ++i)
+      {
+        counts_[i] += other.counts_[i];
+      }
+      count_ += other.count_;
+      sum_ += other.sum_;
+      max_ = std::max(max_, other.max_);
+    }
+
+    // Get the number of values recorded.
+    std::uint64_t count() const { return count_; }
+
+    // Get the sum of the values recorded.
+    std::uint64_t sum() const { return sum_; }
+
+    // Get the largest value recorded (or zero if there is none).
+    std::uint64_t max() const { return max_; }
+
+    // Get (an upper bound within the resolution of the histogram on) the
+    // value below which the fraction q of the recorded values fall.
+    std::uint64_t quantile(double q) const
+    {
+      const std::uint64_t target = std::max<std::uint64_t>(1,
+        std::uint64_t(std::ceil(q * double(count_))));
+      std::uint64_t seen = 0;
+      for (int i = 0; i < bucket_count; ++i)
+      {
+        seen += counts_[i];
+        if (seen >= target)
+        {
+          return std::min(highest_equivalent(i), max_);
+        }
+      }
+      return max_;
+    }
+
+    // Remove all recorded values.
+    void clear()
+    {
+      counts_.fill(0);
+      count_ = 0;
+      sum_ = 0;
+      max_ = 0;
+    }
+
+    // Write a summary of the histogram to out as a JSON object.
+    void write_json(std::ostream& out) const
+    {
+      out << "{\"count\": " << count_ << ", \"mean\": "
+        << (count_ > 0 ? double(sum_) / double(count_) : 0.0)
+        << ", \"p50\": " << quantile(0.5) << ", \"p90\": " << quantile(0.9)
+        << ", \"p99\": " << quantile(0.99) << ", \"p999\": "
+        << quantile(0.999) << ", \"max\": " << max_ << "}";
+    }
+
+  private:
+    static constexpr int sub_buckets = 1 << sub_bucket_bits;
+    static constexpr int bucket_count = (64 - sub_bucket_bits + 1) *
+      sub_buckets;
+
+    static int magnitude(std::uint64_t value)
+    {
+#if defined(__GNUC__)
+      return 63 - __builtin_clzll(value);
+#else
+      int m = 0;
+      while (value >>= 1)
+      {
+        ++m;
+      }
+      return m;
+#endif
+    }
+
+    static int index(std::uint64_t value)
+    {
+      if (value < std::uint64_t(sub_buckets))
+      {
+        return int(value);
+      }
+      const int shift = magnitude(value) - sub_bucket_bits;
+      return (shift + 1) * sub_buckets +
+        int((value >> shift) & (sub_buckets - 1));
+    }
+
+    // Get the largest value that falls into the bucket i.
+    static std::uint64_t highest_equivalent(int i)
+    {
+      if (i < sub_buckets)
+      {
+        return std::uint64_t(i);
+      }
+      const int shift = i / sub_buckets - 1;
+      return ((std::uint64_t(sub_buckets + i % sub_buckets) << shift) +
+        (std::uint64_t(1) << shift)) - 1;
+    }
+
+    std::array<std::uint64_t, bucket_count> counts_;
+    std::uint64_t count_;
+    std::uint64_t sum_;
+    std::uint64_t max_;
+};
+
+// Measures the time between consecutive calls of record, which adds each
+// time to a histogram.
+class stopwatch {
+  public:
+    stopwatch() : last_(std::chrono::steady_clock::now()) { }
+
+    void record(latency_histogram& histogram)
+    {
+      const auto now = std::chrono::steady_clock::now();
+      histogram.record(std::uint64_t(std::chrono::duration_cast<
+        std::chrono::nanoseconds>(now - last_).count()));
+      last_ = now;
+    }
+
+  private:
+    std::chrono::steady_clock::time_point last_;
+};
+
+}
+}
+
+#endif
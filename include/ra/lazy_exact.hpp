@@ -0,0 +1,238 @@
+#ifndef lazy_exact_hpp
+#define lazy_exact_hpp
+
+#include "interval.hpp"
+#include <CGAL/MP_Float.h>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace ra
+{
+namespace math {
+
+// A number that is computed lazily-exactly.
+// Each value carries an interval approximation and the expression (a DAG
+// of additions, subtractions, and multiplications whose leaves are
+// values of type T) that defines it.  Arithmetic only updates the
+// interval and records the operation; the exact value (of type
+// CGAL::MP_Float) is computed on demand, for instance when the interval
+// cannot certify the sign.  Exact values are cached, and once the exact
+// value of a node is known, the subexpressions below it are released.
+// Neither evaluation nor release recurses, so expressions may be
+// arbitrarily deep (e.g., a sum accumulated term by term).
+// Copies of a value share its nodes, and evaluating a value updates them,
+// so a value and its copies must not be used in different threads at the
+// same time.
+template <class T>
+class lazy_exact{
+  public:
+    using real_type = T;
+    using exact_type = CGAL::MP_Float;
+
+    struct statistics {
+      // The total number of expression nodes evaluated exactly.
+      unsigned long exact_evaluation_count ;
+    };
+
+    lazy_exact(real_type real_val = real_type(0)) : approx_(real_val),
+      node_(std::make_shared<node>(real_val)) { }
+
+    lazy_exact(lazy_exact&&) = default;
+    lazy_exact& operator=(lazy_exact&&) = default;
+
+    lazy_exact(const lazy_exact&) = default;
+    lazy_exact& operator=(const lazy_exact&) = default;
+
+    ~lazy_exact() = default;
+
+    lazy_exact& operator+=(const lazy_exact& other)
+    {
+      approx_ += other.approx_;
+      node_ = std::make_shared<node>(operation::add, node_, other.node_);
+      return *this;
+    }
+
+    lazy_exact& operator-=(const lazy_exact& other)
+    {
+      approx_ -= other.approx_;
+      node_ = std::make_shared<node>(operation::sub, node_, other.node_);
+      return *this;
+    }
+
+    lazy_exact& operator*=(const lazy_exact& other)
+    {
+      approx_ *= other.approx_;
+      node_ = std::make_shared<node>(operation::mul, node_, other.node_);
+      return *this;
+    }
+
+    // Get the interval approximation of the value.
+    const interval<real_type>& approx() const
+    {
+      return approx_;
+    }
+
+    // Get the exact value, evaluating the expression if needed.
+    const exact_type& exact() const
+    {
+      return evaluate(*node_);
+    }
+
+    // Get the sign of the value.  The interval approximation is used if
+    // it suffices; otherwise the value is evaluated exactly.
+    int sign() const
+    {
+      try
+      {
+        return approx_.sign();
+      }
+      catch(indeterminate_result& e)
+      {
+        return int(exact().sign());
+      }
+    }
+
+    static void clear_statistics()
+    {
+      stats_.exact_evaluation_count = 0;
+    }
+
+    static void get_statistics(statistics& stats)
+    {
+      stats.exact_evaluation_count = stats_.exact_evaluation_count;
+    }
+
+  private:
+    enum class operation { leaf, add, sub, mul };
+
+    // A node of the expression DAG.
+    struct node
+    {
+      node(real_type value_) : op(operation::leaf), value(value_) { }
+      node(operation op_, std::shared_ptr<const node> left_,
+        std::shared_ptr<const node> right_) : op(op_), value(0),
+        left(std::move(left_)), right(std::move(right_)) { }
+      node(const node&) = delete;
+      node& operator=(const node&) = delete;
+
+      // Release the subexpressions iteratively: the children of a node
+      // that is about to be destroyed are taken over first, so that no
+      // destructor releases more than a node without children.
+      ~node()
+      {
+        if (!left && !right)
+        {
+          return;
+        }
+        std::vector<std::shared_ptr<const node>> pending;
+        pending.push_back(std::move(left));
+        pending.push_back(std::move(right));
+        while (!pending.empty())
+        {
+          std::shared_ptr<const node> n = std::move(pending.back());
+          pending.pop_back();
+          if (n && n.use_count() == 1)
+          {
+            pending.push_back(std::move(n->left));
+            pending.push_back(std::move(n->right));
+          }
+        }
+      }
+
+      operation op;
+      real_type value;
+      mutable std::shared_ptr<const node> left;
+      mutable std::shared_ptr<const node> right;
+      mutable std::optional<exact_type> exact;
+    };
+
+    // Evaluate the node exactly, depth first with an explicit stack of
+    // the nodes whose operands are not evaluated yet.
+    static const exact_type& evaluate(const node& root)
+    {
+      std::vector<const node*> stack;
+      if (!root.exact)
+      {
+        stack.push_back(&root);
+      }
+      while (!stack.empty())
+      {
+        // The nodes on the stack are ancestors of the ones above them, so
+        // none is evaluated yet.
+        const node& n = *stack.back();
+        if (n.op != operation::leaf)
+        {
+          if (!n.left->exact)
+          {
+            stack.push_back(n.left.get());
+            continue;
+          }
+          if (!n.right->exact)
+          {
+            stack.push_back(n.right.get());
+            continue;
+          }
+        }
+        ++stats_.exact_evaluation_count;
+        switch (n.op)
+        {
+        case operation::leaf:
+          n.exact = exact_type(n.value);
+          break;
+        case operation::add:
+          n.exact = *n.left->exact + *n.right->exact;
+          break;
+        case operation::sub:
+          n.exact = *n.left->exact - *n.right->exact;
+          break;
+        case operation::mul:
+          n.exact = *n.left->exact * *n.right->exact;
+          break;
+        }
+        n.left.reset();
+        n.right.reset();
+        stack.pop_back();
+      }
+      return *root.exact;
+    }
+
+    interval<real_type> approx_;
+    std::shared_ptr<const node> node_;
+
+    // The statistics are kept per thread.
+    static thread_local statistics stats_;
+};
+
+  template<typename T>
+  thread_local typename lazy_exact<T>::statistics lazy_exact<T>::stats_ = {0};
+
+  template<typename T>
+  lazy_exact<T> operator+(const lazy_exact<T>& a, const lazy_exact<T>& b)
+  {
+      lazy_exact<T> tmp(a);
+      tmp.operator+=(b);
+      return tmp;
+  }
+
+  //binary minus
+  template<typename T>
+  lazy_exact<T> operator-(const lazy_exact<T>& a, const lazy_exact<T>& b)
+  {
+      lazy_exact<T> tmp(a);
+      tmp.operator-=(b);
+      return tmp;
+  }
+
+  //binary multiply
+  template<typename T>
+  lazy_exact<T> operator*(const lazy_exact<T>& a, const lazy_exact<T>& b)
+  {
+      lazy_exact<T> tmp(a);
+      tmp.operator*=(b);
+      return tmp;
+  }
+}
+}
+#endif
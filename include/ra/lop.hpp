@@ -0,0 +1,174 @@
+#ifndef lop_hpp
+#define lop_hpp
+
+#include "kernel.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace ra::geometry{
+
+// The statistics gathered by make_pd_delaunay.
+struct Lop_statistics
+{
+  // The number of passes made over the suspect edges.
+  std::size_t passes;
+  // The number of edges tested for the PD-Delaunay property.
+  std::size_t tests;
+  // The number of edge flips performed.
+  std::size_t flips;
+  // The peak number of bytes allocated for the lists of suspect edges.
+  std::size_t suspect_bytes;
+};
+
+// The progress made by make_pd_delaunay in one pass.
+struct Lop_pass
+{
+  // The number of the pass (starting at 1).
+  std::size_t pass;
+  // The number of edges tested during the pass.
+  std::size_t tests;
+  // The number of edges flipped during the pass.
+  std::size_t flips;
+  // The number of suspect edges left for the next pass.
+  std::size_t suspects;
+};
+
+namespace detail {
+
+// Apply the LOP to the triangulation tri, starting with the edges of the
+// halfedges in suspects (one halfedge of each edge, without duplicates)
+// as described for make_pd_delaunay.
+template <class Triangulation, class Pass_observer>
+Lop_statistics lop(Triangulation& tri,
+  const typename Triangulation::Kernel::Vector_2& u,
+  const typename Triangulation::Kernel::Vector_2& v,
+  std::vector<typename Triangulation::Halfedge_handle> suspects,
+  Pass_observer&& on_pass)
+{
+  using Halfedge_handle = typename Triangulation::Halfedge_handle;
+  using Predicates = Kernel<typename Triangulation::Kernel::FT>;
+  const std::less<Halfedge_handle> less;
+
+  Predicates kernel;
+  Lop_statistics statistics = {0, 0, 0, 0};
+  std::vector<Halfedge_handle> next_suspects;
+  while (!suspects.empty())
+  {
+    statistics.suspect_bytes = std::max(statistics.suspect_bytes,
+      (suspects.capacity() + next_suspects.capacity()) *
+      sizeof(Halfedge_handle));
+    ++statistics.passes;
+    const std::size_t tests_before = statistics.tests;
+    const std::size_t flips_before = statistics.flips;
+    next_suspects.clear();
+    for (Halfedge_handle h : suspects)
+    {
+      if (h->is_border() || h->opposite()->is_border())
+      {
+        continue;
+      }
+      // The edge ca with the incident faces abc and acd.
+      ++statistics.tests;
+      const auto& a = h->vertex()->point();
+      const auto& b = h->next()->vertex()->point();
+      const auto& c = h->opposite()->vertex()->point();
+      const auto& d = h->opposite()->next()->vertex()->point();
+      if (!kernel.is_locally_pd_delaunay_edge(a, b, c, d, u, v))
+      {
+        // The edges of the quadrilateral abcd are the same before and
+        // after the flip, and only they can be affected by it.
+        for (Halfedge_handle g : {h->next(), h->next()->next(),
+          h->opposite()->next(), h->opposite()->next()->next()})
+        {
+          next_suspects.push_back(less(g->opposite(), g) ? g->opposite() :
+            g);
+        }
+        tri.flip_edge(h);
+        ++statistics.flips;
+      }
+    }
+    statistics.suspect_bytes = std::max(statistics.suspect_bytes,
+      (suspects.capacity() + next_suspects.capacity()) *
+      sizeof(Halfedge_handle));
+    std::sort(next_suspects.begin(), next_suspects.end(), less);
+    next_suspects.erase(std::unique(next_suspects.begin(),
+      next_suspects.end()), next_suspects.end());
+    suspects.swap(next_suspects);
+    on_pass(Lop_pass{statistics.passes, statistics.tests - tests_before,
+      statistics.flips - flips_before, suspects.size()});
+  }
+  return statistics;
+}
+
+}
+
+// Apply the Lawson local optimization procedure (LOP) to the triangulation
+// tri until every flippable edge has the preferred-directions
+// locally-Delaunay property with respect to the first and second
+// directions u and v.
+// The type Triangulation must provide the interface of
+// trilib::Triangulation_2.
+// The first pass tests every edge.  Each following pass tests only the
+// edges of the quadrilaterals in which an edge was flipped during the
+// previous pass, and the procedure stops after a pass without flips.
+// After each pass, on_pass is called with the Lop_pass describing it.
+// Precondition: The vectors u and v are not zero vectors; the vectors u
+// and v are neither parallel nor orthogonal.
+template <class Triangulation, class Pass_observer>
+Lop_statistics make_pd_delaunay(Triangulation& tri,
+  const typename Triangulation::Kernel::Vector_2& u,
+  const typename Triangulation::Kernel::Vector_2& v,
+  Pass_observer&& on_pass)
+{
+  // Every edge is a suspect initially.
+  std::vector<typename Triangulation::Halfedge_handle> suspects;
+  suspects.reserve(tri.size_of_edges());
+  for (auto h = tri.halfedges_begin(); h != tri.halfedges_end(); ++++h)
+  {
+    suspects.push_back(h);
+  }
+  return detail::lop(tri, u, v, std::move(suspects), on_pass);
+}
+
+// Apply the LOP to the triangulation tri as above, without observing the
+// passes.
+template <class Triangulation>
+Lop_statistics make_pd_delaunay(Triangulation& tri,
+  const typename Triangulation::Kernel::Vector_2& u,
+  const typename Triangulation::Kernel::Vector_2& v)
+{
+  return make_pd_delaunay(tri, u, v, [](const Lop_pass&) {});
+}
+
+// Apply the LOP to the triangulation tri as make_pd_delaunay does, but
+// starting with the edges of the halfedges in suspects only (in any
+// order, and possibly with duplicates).  This restores the
+// preferred-directions Delaunay property after a local change, at a cost
+// proportional to the number of suspects and flips rather than to the
+// size of tri.
+// Precondition: Every flippable edge that is not a suspect has the
+// preferred-directions locally-Delaunay property.
+template <class Triangulation>
+Lop_statistics restore_pd_delaunay(Triangulation& tri,
+  const typename Triangulation::Kernel::Vector_2& u,
+  const typename Triangulation::Kernel::Vector_2& v,
+  std::vector<typename Triangulation::Halfedge_handle> suspects)
+{
+  using Halfedge_handle = typename Triangulation::Halfedge_handle;
+  const std::less<Halfedge_handle> less;
+  for (Halfedge_handle& h : suspects)
+  {
+    h = less(h->opposite(), h) ? h->opposite() : h;
+  }
+  std::sort(suspects.begin(), suspects.end(), less);
+  suspects.erase(std::unique(suspects.begin(), suspects.end()),
+    suspects.end());
+  return detail::lop(tri, u, v, std::move(suspects), [](const Lop_pass&) {});
+}
+
+}
+
+#endif
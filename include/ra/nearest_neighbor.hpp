@@ -0,0 +1,217 @@
+#ifndef nearest_neighbor_hpp
+#define nearest_neighbor_hpp
+
+#include "point_location.hpp"
+#include "spatial_sort.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <queue>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace ra::geometry{
+
+// Nearest-neighbor and k-nearest-neighbor queries on the vertices of a
+// Delaunay triangulation, using the triangulation itself as the search
+// structure.
+// A query jumps to the vertex nearest to the query point among a sample
+// of the vertices (see Point_locator), and then walks greedily over the
+// edges to a neighbouring vertex that is closer, until there is none; in
+// a Delaunay triangulation, the vertex reached is a nearest vertex (from
+// any start).  The greedy walk compares distances rather than
+// orientations, so it is much cheaper than a walk to the face that
+// contains the query point.  The k nearest vertices are found by a
+// best-first expansion from the nearest vertex: since the vertices in any
+// disk induce a connected subgraph of a Delaunay triangulation, the next
+// nearest vertex is always a neighbour of one of the vertices found so
+// far.
+// Distances are compared in floating-point arithmetic, so vertices at
+// (nearly) equal distances may be reported in either order.
+// The type Triangulation must provide the interface of
+// trilib::Triangulation_2; if it is a const type, the results are
+// non-mutable handles.  The search remains valid as long as the
+// locator does.
+// Precondition: The triangulation is a Delaunay triangulation (such as a
+// PD-Delaunay triangulation); otherwise the results are only local
+// minima.
+template <class Triangulation>
+class Nearest_neighbor_search
+{
+public:
+  using Vertex_handle = typename Point_locator<Triangulation>::Vertex_handle;
+  using Point = typename Triangulation::Point;
+
+  explicit Nearest_neighbor_search(Triangulation& tri) : locator_(tri) { }
+
+  // Get a vertex nearest to p.
+  Vertex_handle nearest(const Point& p) const
+  {
+    return descend(locator_.nearest_sample(p), p);
+  }
+
+  // Get the k vertices nearest to p (or all vertices, if there are fewer
+  // than k), in order of increasing distance.
+  std::vector<Vertex_handle> k_nearest(const Point& p, std::size_t k) const
+  {
+    return expand(nearest(p), p, k);
+  }
+
+  // Get a vertex nearest to each of the points, using thread_count
+  // threads.
+  // The points are visited along a Hilbert curve in blocks, which are
+  // handed out to the threads, and within a block each greedy walk starts
+  // where the previous one ended.
+  std::vector<Vertex_handle> nearest(const std::vector<Point>& points,
+    unsigned thread_count) const
+  {
+    std::vector<Vertex_handle> result(points.size());
+    for_each_query(points, thread_count, [&](std::size_t i,
+      Vertex_handle start) {
+      result[i] = descend(start, points[i]);
+      return result[i];
+    });
+    return result;
+  }
+
+  // Get the k vertices nearest to each of the points, using thread_count
+  // threads (see the previous function).
+  std::vector<std::vector<Vertex_handle>> k_nearest(
+    const std::vector<Point>& points, std::size_t k,
+    unsigned thread_count) const
+  {
+    std::vector<std::vector<Vertex_handle>> result(points.size());
+    for_each_query(points, thread_count, [&](std::size_t i,
+      Vertex_handle start) {
+      const Vertex_handle v = descend(start, points[i]);
+      result[i] = expand(v, points[i], k);
+      return v;
+    });
+    return result;
+  }
+
+private:
+  static double squared_distance(Vertex_handle v, const Point& p)
+  {
+    const double dx = double(v->point().x()) - double(p.x());
+    const double dy = double(v->point().y()) - double(p.y());
+    return dx * dx + dy * dy;
+  }
+
+  // Call f for each neighbour of the vertex v.
+  template <class Function>
+  static void for_each_neighbor(Vertex_handle v, Function f)
+  {
+    // Circulate over the halfedges whose target is v.
+    const auto first = v->halfedge();
+    auto h = first;
+    do
+    {
+      f(h->opposite()->vertex());
+      h = h->next()->opposite();
+    } while (h != first);
+  }
+
+  // Walk from the vertex v to ever closer neighbours of p, and get the
+  // vertex at which no neighbour is closer.
+  static Vertex_handle descend(Vertex_handle v, const Point& p)
+  {
+    double distance = squared_distance(v, p);
+    for (;;)
+    {
+      Vertex_handle best = v;
+      for_each_neighbor(v, [&](Vertex_handle u) {
+        const double d = squared_distance(u, p);
+        if (d < distance)
+        {
+          best = u;
+          distance = d;
+        }
+      });
+      if (best == v)
+      {
+        return v;
+      }
+      v = best;
+    }
+  }
+
+  // Get the k vertices nearest to p by a best-first expansion from the
+  // nearest vertex v.
+  static std::vector<Vertex_handle> expand(Vertex_handle v, const Point& p,
+    std::size_t k)
+  {
+    using Candidate = std::pair<double, Vertex_handle>;
+    const auto farther = [](const Candidate& a, const Candidate& b) {
+      return a.first > b.first;
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>,
+      decltype(farther)> candidates(farther);
+    std::set<Vertex_handle> seen;
+    std::vector<Vertex_handle> result;
+    result.reserve(k);
+    candidates.emplace(squared_distance(v, p), v);
+    seen.insert(v);
+    while (result.size() < k && !candidates.empty())
+    {
+      const Vertex_handle u = candidates.top().second;
+      candidates.pop();
+      result.push_back(u);
+      for_each_neighbor(u, [&](Vertex_handle w) {
+        if (seen.insert(w).second)
+        {
+          candidates.emplace(squared_distance(w, p), w);
+        }
+      });
+    }
+    return result;
+  }
+
+  // Call query(i, start) for each index i of points, where start is a
+  // vertex from which to descend to the nearest vertex of points[i];
+  // query returns that vertex.
+  template <class Query>
+  void for_each_query(const std::vector<Point>& points,
+    unsigned thread_count, Query query) const
+  {
+    const std::size_t block_size = 1024;
+    const std::vector<std::size_t> order = hilbert_order(points);
+    std::atomic<std::size_t> next_block(0);
+    const auto work = [&] {
+      for (;;)
+      {
+        const std::size_t begin = next_block.fetch_add(block_size);
+        if (begin >= order.size())
+        {
+          break;
+        }
+        const std::size_t end = std::min(begin + block_size, order.size());
+        Vertex_handle v = locator_.nearest_sample(points[order[begin]]);
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          v = query(order[i], v);
+        }
+      }
+    };
+
+    thread_count = unsigned(std::max<std::size_t>(1, std::min<std::size_t>(
+      thread_count, (points.size() + block_size - 1) / block_size)));
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < thread_count; ++i)
+    {
+      threads.emplace_back(work);
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+  }
+
+  Point_locator<Triangulation> locator_;
+};
+
+}
+
+#endif
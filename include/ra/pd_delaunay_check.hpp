@@ -0,0 +1,118 @@
+#ifndef pd_delaunay_check_hpp
+#define pd_delaunay_check_hpp
+
+#include "kernel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ra::geometry{
+
+// The result of check_pd_delaunay.
+template <class Triangulation>
+struct Pd_delaunay_check
+{
+  // The flippable edges found not to have the preferred-directions
+  // locally-Delaunay property (one halfedge of each).
+  std::vector<typename Triangulation::Halfedge_const_handle> violations;
+  // The kernel statistics of all the threads that made the tests.
+  typename Kernel<typename Triangulation::Kernel::FT>::Statistics statistics;
+};
+
+// Test whether every flippable edge of the triangulation tri has the
+// preferred-directions locally-Delaunay property with respect to the
+// first and second directions u and v, using thread_count threads.
+// The type Triangulation must provide the interface of
+// trilib::Triangulation_2.  The triangulation is not modified.
+// The edges are handed out to the threads in blocks.  If find_all is
+// false, the threads stop once a violation is found, so that only the
+// first violation (or the few found at about the same time) are
+// reported; otherwise all violations are reported, in the order of their
+// handles.
+// Precondition: The vectors u and v are not zero vectors; the vectors u
+// and v are neither parallel nor orthogonal.
+template <class Triangulation>
+Pd_delaunay_check<Triangulation> check_pd_delaunay(const Triangulation& tri,
+  const typename Triangulation::Kernel::Vector_2& u,
+  const typename Triangulation::Kernel::Vector_2& v,
+  unsigned thread_count, bool find_all)
+{
+  using Halfedge_const_handle = typename Triangulation::Halfedge_const_handle;
+  using Predicates = Kernel<typename Triangulation::Kernel::FT>;
+  const std::size_t block_size = 1024;
+
+  std::vector<Halfedge_const_handle> edges;
+  edges.reserve(tri.size_of_edges());
+  for (auto h = tri.halfedges_begin(); h != tri.halfedges_end(); ++++h)
+  {
+    if (!h->is_border() && !h->opposite()->is_border())
+    {
+      edges.push_back(h);
+    }
+  }
+
+  Pd_delaunay_check<Triangulation> result;
+  result.statistics = typename Predicates::Statistics();
+  std::atomic<std::size_t> next_block(0);
+  std::atomic<bool> found(false);
+  std::mutex result_mutex;
+  const auto work = [&] {
+    Predicates kernel;
+    Predicates::clear_statistics();
+    std::vector<Halfedge_const_handle> violations;
+    for (;;)
+    {
+      const std::size_t begin = next_block.fetch_add(block_size);
+      if (begin >= edges.size() || (!find_all && found.load()))
+      {
+        break;
+      }
+      const std::size_t end = std::min(begin + block_size, edges.size());
+      for (std::size_t i = begin; i < end; ++i)
+      {
+        // The edge ca with the incident faces abc and acd.
+        const Halfedge_const_handle h = edges[i];
+        if (!kernel.is_locally_pd_delaunay_edge(h->vertex()->point(),
+          h->next()->vertex()->point(), h->opposite()->vertex()->point(),
+          h->opposite()->next()->vertex()->point(), u, v))
+        {
+          violations.push_back(h);
+          if (!find_all)
+          {
+            found = true;
+            break;
+          }
+        }
+      }
+    }
+    typename Predicates::Statistics statistics;
+    Predicates::get_statistics(statistics);
+    std::lock_guard<std::mutex> lock(result_mutex);
+    result.violations.insert(result.violations.end(), violations.begin(),
+      violations.end());
+    Predicates::accumulate_statistics(result.statistics, statistics);
+  };
+
+  thread_count = unsigned(std::max<std::size_t>(1, std::min<std::size_t>(
+    thread_count, (edges.size() + block_size - 1) / block_size)));
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < thread_count; ++i)
+  {
+    threads.emplace_back(work);
+  }
+  for (auto& thread : threads)
+  {
+    thread.join();
+  }
+  std::sort(result.violations.begin(), result.violations.end(),
+    std::less<Halfedge_const_handle>());
+  return result;
+}
+
+}
+
+#endif
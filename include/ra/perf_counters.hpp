@@ -0,0 +1,227 @@
+#ifndef perf_counters_hpp
+#define perf_counters_hpp
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace ra
+{
+namespace profiling {
+
+// Performance counters of the calling thread, read with the Linux
+// perf_event_open interface: CPU cycles, instructions, branch misses, L1
+// data cache and last-level cache read misses, and (as a software event,
+// which is available even where the hardware events are not) the CPU
+// time.
+// The events are counted in user space only, which an unprivileged
+// process may do with the default perf_event_paranoid setting.  Events
+// that cannot be counted (e.g., in a virtual machine without a virtual
+// PMU, or on other systems than Linux) are unavailable rather than
+// errors, and read as zero, so that a harness can report whatever there
+// is.  If the kernel multiplexes the counters (when there are more events
+// than hardware counters), the counts are scaled by the fraction of the
+// time during which each counter was running.
+// Counting starts when the object is made; the counts for a section of
+// code are the difference of the readings before and after it.
+class perf_counters {
+  public:
+    enum event {
+      cycles,
+      instructions,
+      branch_misses,
+      l1d_read_misses,
+      llc_read_misses,
+      task_clock_ns,
+      event_count
+    };
+
+    // The counts of all events at some time.
+    struct reading {
+      std::array<std::uint64_t, event_count> values;
+
+      std::uint64_t operator[](int e) const { return values[e]; }
+
+      reading& operator-=(const reading& other)
+      {
+        for (int e = 0; e < event_count; ++e)
+        {
+          values[e] -= other.values[e];
+        }
+        return *this;
+      }
+
+      reading& operator+=(const reading& other)
+      {
+        for (int e = 0; e < event_count; ++e)
+        {
+          values[e] += other.values[e];
+        }
+        return *this;
+      }
+
+      friend reading operator-(reading a, const reading& b)
+      {
+        return a -= b;
+      }
+    };
+
+    perf_counters()
+    {
+      for (int e = 0; e < event_count; ++e)
+      {
+        fds_[e] = open(event(e));
+      }
+    }
+
+    ~perf_counters()
+    {
+#if defined(__linux__)
+      for (int fd : fds_)
+      {
+        if (fd >= 0)
+        {
+          close(fd);
+        }
+      }
+#endif
+    }
+
+    perf_counters(perf_counters&&) = delete;
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(perf_counters&&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    // Tell whether the event e is counted.
+    bool available(int e) const
+    {
+      return fds_[e] >= 0;
+    }
+
+    // Tell whether any hardware event is counted.
+    bool any_hardware_available() const
+    {
+      for (int e = 0; e < task_clock_ns; ++e)
+      {
+        if (available(e))
+        {
+          return true;
+        }
+      }
+      return false;
+    }
+
+    // Get the counts of the events since the object was made (scaled if
+    // the counters are multiplexed).
+    // A scaled count is an estimate, and a later estimate can be smaller
+    // than an earlier one.
+    reading read() const
+    {
+      return read(true);
+    }
+
+    // Get the counts of the events since the object was made, without
+    // scaling (i.e., the counts while each counter was running, which
+    // never decrease).
+    reading read_unscaled() const
+    {
+      return read(false);
+    }
+
+    // Get a short name of the event e.
+    static const char* name(int e)
+    {
+      static const char* const names[event_count] = {"cycles",
+        "instructions", "branch-misses", "L1d-misses", "LLC-misses",
+        "task-clock-ns"};
+      return names[e];
+    }
+
+  private:
+    std::array<int, event_count> fds_;
+
+    reading read(bool scaled) const
+    {
+      reading result = {};
+#if defined(__linux__)
+      for (int e = 0; e < event_count; ++e)
+      {
+        // The count, the time enabled, and the time running.
+        std::uint64_t values[3];
+        if (fds_[e] >= 0 && ::read(fds_[e], values, sizeof(values)) ==
+          ssize_t(sizeof(values)))
+        {
+          result.values[e] = !scaled || values[2] == 0 ||
+            values[2] == values[1] ? values[0] :
+            std::uint64_t(double(values[0]) * double(values[1]) /
+            double(values[2]));
+        }
+      }
+#else
+      static_cast<void>(scaled);
+#endif
+      return result;
+    }
+
+    // Open a counter for the event e of the calling thread, and get its
+    // file descriptor (or -1 if it cannot be counted).
+    static int open(event e)
+    {
+#if defined(__linux__)
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+        PERF_FORMAT_TOTAL_TIME_RUNNING;
+      const auto cache_read_miss = [](std::uint64_t cache) {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+      };
+      switch (e)
+      {
+        case cycles:
+          attr.type = PERF_TYPE_HARDWARE;
+          attr.config = PERF_COUNT_HW_CPU_CYCLES;
+          break;
+        case instructions:
+          attr.type = PERF_TYPE_HARDWARE;
+          attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+          break;
+        case branch_misses:
+          attr.type = PERF_TYPE_HARDWARE;
+          attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+          break;
+        case l1d_read_misses:
+          attr.type = PERF_TYPE_HW_CACHE;
+          attr.config = cache_read_miss(PERF_COUNT_HW_CACHE_L1D);
+          break;
+        case llc_read_misses:
+          attr.type = PERF_TYPE_HW_CACHE;
+          attr.config = cache_read_miss(PERF_COUNT_HW_CACHE_LL);
+          break;
+        default:
+          attr.type = PERF_TYPE_SOFTWARE;
+          attr.config = PERF_COUNT_SW_TASK_CLOCK;
+          break;
+      }
+      // This thread, on any CPU, in no group.
+      return int(syscall(SYS_perf_event_open, &attr, 0, -1, -1,
+        PERF_FLAG_FD_CLOEXEC));
+#else
+      static_cast<void>(e);
+      return -1;
+#endif
+    }
+};
+
+}
+}
+
+#endif
@@ -0,0 +1,209 @@
+#ifndef point_location_hpp
+#define point_location_hpp
+
+#include "kernel.hpp"
+#include "spatial_sort.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace ra::geometry{
+
+// The possible positions of a point relative to a triangulation.
+enum class Locate_type { vertex, edge, face, outside };
+
+// The result of locating a point p in a triangulation.
+// The halfedge depends on the type:
+//   vertex   a halfedge whose target vertex is at p
+//   edge     a halfedge of a face whose edge contains p in its interior
+//   face     a halfedge of the face that contains p in its interior
+//   outside  a border halfedge whose edge has p strictly on its outer side
+//            (p is outside the convex hull of the triangulation)
+template <class Halfedge_handle>
+struct Location
+{
+  Locate_type type;
+  Halfedge_handle halfedge;
+};
+
+// Locate the point p in a triangulation by walking from the face of the
+// halfedge start (or of its opposite, if start is a border halfedge).
+// The walk moves to a neighbouring face through an edge that has p
+// strictly on its other side, trying the edges of each face in a random
+// order (except the edge through which the face was entered).  This
+// stochastic visibility walk terminates on any triangulation (not only on
+// Delaunay triangulations), and since all tests are exact orientation
+// tests, degenerate cases (e.g., p on an edge or at a vertex) are
+// classified correctly.
+// The type Halfedge_handle is a (mutable or non-mutable) halfedge handle
+// of a triangulation with the interface of trilib::Triangulation_2.
+template <class R, class Halfedge_handle>
+Location<Halfedge_handle> walk_to(Kernel<R>& kernel, Halfedge_handle start,
+  const typename Kernel<R>::Point& p)
+{
+  using Orientation = typename Kernel<R>::Orientation;
+
+  Halfedge_handle h = start->is_border() ? start->opposite() : start;
+  Halfedge_handle entered = Halfedge_handle();
+  // A xorshift generator (the walk only needs a cheap source of
+  // randomness, and a fixed seed keeps the results reproducible).
+  std::uint32_t random = 0x9e3779b9u;
+  for (;;)
+  {
+    random ^= random << 13;
+    random ^= random >> 17;
+    random ^= random << 5;
+    const Halfedge_handle edges[3] = {h, h->next(), h->next()->next()};
+    const unsigned first = random % 3;
+    Halfedge_handle next = Halfedge_handle();
+    for (unsigned i = 0; i < 3; ++i)
+    {
+      const Halfedge_handle e = edges[(first + i) % 3];
+      if (e != entered && kernel.orientation(e->opposite()->vertex()->point(),
+        e->vertex()->point(), p) == Orientation::right_turn)
+      {
+        next = e->opposite();
+        break;
+      }
+    }
+    if (next == Halfedge_handle())
+    {
+      break;
+    }
+    if (next->is_border())
+    {
+      return {Locate_type::outside, next};
+    }
+    h = next;
+    entered = next;
+  }
+
+  // The point is in the closed face of h.
+  const Halfedge_handle edges[3] = {h, h->next(), h->next()->next()};
+  bool on_edge[3];
+  int count = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    on_edge[i] = edges[i] != entered && kernel.orientation(
+      edges[i]->opposite()->vertex()->point(), edges[i]->vertex()->point(),
+      p) == Orientation::collinear;
+    count += on_edge[i];
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    if (on_edge[i] && (count == 1 || on_edge[(i + 1) % 3]))
+    {
+      // On the edge i alone, or at its target vertex (shared with the
+      // edge i + 1).
+      return {count == 1 ? Locate_type::edge : Locate_type::vertex,
+        edges[i]};
+    }
+  }
+  return {Locate_type::face, h};
+}
+
+// Point location in a triangulation by jump-and-walk.
+// A sample of about c n^(1/3) of the n vertices is taken when the locator
+// is made; a query starts from the sampled vertex nearest to the query
+// point and walks from there (see walk_to).  For uniformly distributed
+// points the expected cost of a query is therefore about O(n^(1/3)).  The
+// constant c = 16 balances the cheap distance computations of the jump
+// against the far more expensive orientation tests of the walk.
+// The type Triangulation must provide the interface of
+// trilib::Triangulation_2; if it is a const type, the locations refer to
+// non-mutable handles.  The locator remains valid as long as the sampled
+// vertices exist (e.g., edge flips do not invalidate it).
+// Precondition: The triangulation has at least one face.
+template <class Triangulation>
+class Point_locator
+{
+public:
+  using Halfedge_handle = decltype(
+    std::declval<Triangulation&>().halfedges_begin());
+  using Vertex_handle = decltype(
+    std::declval<Triangulation&>().vertices_begin());
+  using Point = typename Triangulation::Point;
+  using Location = ra::geometry::Location<Halfedge_handle>;
+
+  explicit Point_locator(Triangulation& tri)
+  {
+    const std::size_t n = tri.size_of_vertices();
+    const std::size_t sample_size = std::max<std::size_t>(1, std::min(n,
+      std::size_t(16 * std::cbrt(double(n)))));
+    const std::size_t stride = std::max<std::size_t>(1, n / sample_size);
+    samples_.reserve(sample_size);
+    std::size_t i = 0;
+    for (auto v = tri.vertices_begin(); v != tri.vertices_end(); ++v, ++i)
+    {
+      if (i % stride == 0 && samples_.size() < sample_size)
+      {
+        samples_.push_back(v);
+      }
+    }
+  }
+
+  // Locate the point p.
+  Location locate(const Point& p) const
+  {
+    Kernel<typename Triangulation::Kernel::FT> kernel;
+    return walk_to(kernel, nearest_sample(p)->halfedge(), p);
+  }
+
+  // Locate the point p, walking from the face of the halfedge hint
+  // (e.g., the halfedge of the location of a nearby point).
+  Location locate(const Point& p, Halfedge_handle hint) const
+  {
+    Kernel<typename Triangulation::Kernel::FT> kernel;
+    return walk_to(kernel, hint, p);
+  }
+
+  // Locate each of the points.
+  // The points are visited along a Hilbert curve, and each walk starts
+  // where the walk for the previous point ended, so that queries that
+  // are close together are answered by short walks.
+  std::vector<Location> locate(const std::vector<Point>& points) const
+  {
+    Kernel<typename Triangulation::Kernel::FT> kernel;
+    std::vector<Location> result(points.size());
+    Halfedge_handle hint = Halfedge_handle();
+    for (std::size_t i : hilbert_order(points))
+    {
+      result[i] = walk_to(kernel, hint == Halfedge_handle() ?
+        nearest_sample(points[i])->halfedge() : hint, points[i]);
+      hint = result[i].halfedge;
+    }
+    return result;
+  }
+
+  // Get the sampled vertex nearest to p (as far as floating-point
+  // distances tell, which is good enough to choose a start), from which
+  // the walk of a query starts.
+  Vertex_handle nearest_sample(const Point& p) const
+  {
+    Vertex_handle best = samples_.front();
+    double best_distance = std::numeric_limits<double>::infinity();
+    for (const Vertex_handle& v : samples_)
+    {
+      const double dx = double(v->point().x()) - double(p.x());
+      const double dy = double(v->point().y()) - double(p.y());
+      const double distance = dx * dx + dy * dy;
+      if (distance < best_distance)
+      {
+        best = v;
+        best_distance = distance;
+      }
+    }
+    return best;
+  }
+
+private:
+  std::vector<Vertex_handle> samples_;
+};
+
+}
+
+#endif
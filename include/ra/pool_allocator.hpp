@@ -0,0 +1,252 @@
+#ifndef pool_allocator_hpp
+#define pool_allocator_hpp
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace ra
+{
+namespace memory {
+
+namespace detail {
+
+// The alignment of every node handed out by the pools.
+constexpr std::size_t node_alignment = alignof(std::max_align_t);
+// The largest allocation served by the pools.
+constexpr std::size_t max_node_size = 32 * node_alignment;
+// The size of each block of memory obtained from operator new.
+constexpr std::size_t block_size = std::size_t(1) << 16;
+constexpr std::size_t size_class_count = max_node_size / node_alignment;
+
+// A free node, linked to the next free node of the same size.
+struct free_node {
+  free_node* next;
+};
+
+// The memory shared by all threads: every block ever obtained (blocks are
+// never returned to the system, so that nodes stay valid whichever thread
+// frees them), and the lists of free nodes left behind by threads that
+// have exited, for reuse by other threads.
+struct shared_pools {
+  std::mutex mutex;
+  std::vector<void*> blocks;
+  std::array<std::vector<free_node*>, size_class_count> orphans;
+};
+
+inline shared_pools& shared()
+{
+  // Deliberately never destroyed, since nodes may still be freed during
+  // the destruction of static objects.
+  static shared_pools* pools = new shared_pools;
+  return *pools;
+}
+
+// Arrange for the free nodes of the calling thread to be handed to the
+// shared pools when the thread exits.
+void register_thread_exit();
+
+// The nodes of one size, as used by one thread.  Nodes are carved in
+// order from large blocks, and freed nodes are kept in a list for reuse.
+class size_class_pool {
+  public:
+    void* allocate(std::size_t node_size)
+    {
+      if (!free_)
+      {
+        if (next_ == end_)
+        {
+          refill(node_size);
+        }
+        if (!free_)
+        {
+          void* p = next_;
+          next_ += node_size;
+          return p;
+        }
+      }
+      free_node* n = free_;
+      free_ = n->next;
+      return n;
+    }
+
+    void deallocate(void* p)
+    {
+      free_node* n = static_cast<free_node*>(p);
+      n->next = free_;
+      free_ = n;
+    }
+
+    // Hand all the free nodes to the shared pools.
+    void release(std::size_t node_size, std::size_t size_class)
+    {
+      for (; next_ != end_; next_ += node_size)
+      {
+        deallocate(next_);
+      }
+      if (free_)
+      {
+        std::lock_guard<std::mutex> lock(shared().mutex);
+        shared().orphans[size_class].push_back(free_);
+        free_ = nullptr;
+      }
+    }
+
+  private:
+    void refill(std::size_t node_size)
+    {
+      register_thread_exit();
+      const std::size_t size_class = node_size / node_alignment - 1;
+      shared_pools& pools = shared();
+      std::lock_guard<std::mutex> lock(pools.mutex);
+      if (!pools.orphans[size_class].empty())
+      {
+        free_ = pools.orphans[size_class].back();
+        pools.orphans[size_class].pop_back();
+        return;
+      }
+      pools.blocks.reserve(pools.blocks.size() + 1);
+      char* block = static_cast<char*>(::operator new(block_size));
+      pools.blocks.push_back(block);
+      next_ = block;
+      end_ = block + block_size / node_size * node_size;
+    }
+
+    free_node* free_ = nullptr;
+    char* next_ = nullptr;
+    char* end_ = nullptr;
+};
+
+// The pools of all the size classes, as used by one thread.
+// The pools are trivially destructible, so that they remain usable while
+// the thread-local and static objects are destroyed; a node freed after
+// the pools were released is simply not reused.
+class thread_pools {
+  public:
+    void release()
+    {
+      for (std::size_t i = 0; i < size_class_count; ++i)
+      {
+        pools_[i].release((i + 1) * node_alignment, i);
+      }
+    }
+
+    void* allocate(std::size_t size)
+    {
+      const std::size_t i = size_class(size);
+      return pools_[i].allocate((i + 1) * node_alignment);
+    }
+
+    void deallocate(void* p, std::size_t size)
+    {
+      pools_[size_class(size)].deallocate(p);
+    }
+
+  private:
+    static std::size_t size_class(std::size_t size)
+    {
+      return size == 0 ? 0 : (size - 1) / node_alignment;
+    }
+
+    std::array<size_class_pool, size_class_count> pools_;
+};
+
+inline thread_pools& local()
+{
+  static thread_local thread_pools pools;
+  return pools;
+}
+
+inline void register_thread_exit()
+{
+  struct exit_hook {
+    ~exit_hook() { local().release(); }
+  };
+  static thread_local exit_hook hook;
+  (void)hook;
+}
+
+}
+
+// A stateless allocator that serves small allocations (such as the
+// vertices, halfedges, and faces of a halfedge data structure) from pools
+// of nodes of the same size.
+// The nodes are carved in order from large contiguous blocks, so that
+// nodes allocated one after the other are adjacent in memory, and
+// allocating or freeing a node takes only a few instructions and no
+// synchronization.  Freed nodes are kept by the freeing thread for reuse
+// (so that memory can be allocated in one thread and freed in another),
+// and the free nodes of a thread are handed to the other threads when it
+// exits.  The blocks are never returned to the system; their memory is
+// reused by later allocations of the same size instead.
+// Allocations larger than a few hundred bytes or with an extended
+// alignment are passed on to std::allocator.
+template <class T>
+class pool_allocator {
+  public:
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    pool_allocator() noexcept = default;
+
+    template <class U>
+    pool_allocator(const pool_allocator<U>&) noexcept { }
+
+    T* allocate(std::size_t n)
+    {
+      if (!pooled(n))
+      {
+        return std::allocator<T>().allocate(n);
+      }
+      return static_cast<T*>(detail::local().allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+      if (!pooled(n))
+      {
+        std::allocator<T>().deallocate(p, n);
+        return;
+      }
+      detail::local().deallocate(p, n * sizeof(T));
+    }
+
+    // Get the number of bytes of memory taken by an allocation of n
+    // objects (e.g., for estimates of memory use): the size rounded up to
+    // the node alignment, since nodes have no headers, or zero if the
+    // allocation is passed on to std::allocator.
+    static std::size_t node_size(std::size_t n)
+    {
+      return pooled(n) ? (n * sizeof(T) + detail::node_alignment - 1) /
+        detail::node_alignment * detail::node_alignment : 0;
+    }
+
+  private:
+    static bool pooled(std::size_t n)
+    {
+      return alignof(T) <= detail::node_alignment &&
+        n <= detail::max_node_size / sizeof(T);
+    }
+};
+
+template <class T, class U>
+bool operator==(const pool_allocator<T>&, const pool_allocator<U>&)
+{
+  return true;
+}
+
+template <class T, class U>
+bool operator!=(const pool_allocator<T>&, const pool_allocator<U>&)
+{
+  return false;
+}
+
+}
+}
+
+#endif
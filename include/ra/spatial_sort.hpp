@@ -0,0 +1,126 @@
+#ifndef spatial_sort_hpp
+#define spatial_sort_hpp
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace ra::geometry{
+
+// Get the position of the cell (x, y) along a Hilbert curve that covers a
+// 2^31 by 2^31 grid of cells.
+inline std::uint64_t hilbert_index(std::uint32_t x, std::uint32_t y)
+{
+  std::uint64_t d = 0;
+  for (std::uint32_t s = std::uint32_t(1) << 30; s > 0; s >>= 1)
+  {
+    const std::uint32_t rx = (x & s) ? 1 : 0;
+    const std::uint32_t ry = (y & s) ? 1 : 0;
+    d += std::uint64_t(s) * s * ((3 * rx) ^ ry);
+    // Rotate the quadrant so that the curve stays continuous.  Only the
+    // bits below s matter from here on, so wrapping around is harmless.
+    if (ry == 0)
+    {
+      if (rx == 1)
+      {
+        x = s - 1 - x;
+        y = s - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return d;
+}
+
+// Sort the indices in [first, last), which refer to elements of points,
+// so that the corresponding points follow a Hilbert curve over their
+// bounding box.
+// Points that are close along the curve are close in the plane, so
+// visiting points in this order gives good memory locality.
+template <class Point, class Iterator>
+void hilbert_sort(const std::vector<Point>& points, Iterator first,
+  Iterator last)
+{
+  if (last - first < 2)
+  {
+    return;
+  }
+  double min_x = points[*first].x();
+  double max_x = min_x;
+  double min_y = points[*first].y();
+  double max_y = min_y;
+  for (auto i = first; i != last; ++i)
+  {
+    min_x = std::min(min_x, double(points[*i].x()));
+    max_x = std::max(max_x, double(points[*i].x()));
+    min_y = std::min(min_y, double(points[*i].y()));
+    max_y = std::max(max_y, double(points[*i].y()));
+  }
+  // The key only needs to be monotone in the coordinates, so the
+  // (inexact) scaling below does not affect correctness.
+  const double extent = std::max(max_x - min_x, max_y - min_y);
+  const double scale = extent > 0 ? double((std::uint32_t(1) << 31) - 1) /
+    extent : 0;
+
+  std::vector<std::pair<std::uint64_t, std::size_t>> keys;
+  keys.reserve(last - first);
+  for (auto i = first; i != last; ++i)
+  {
+    const auto qx = std::uint32_t((points[*i].x() - min_x) * scale);
+    const auto qy = std::uint32_t((points[*i].y() - min_y) * scale);
+    keys.emplace_back(hilbert_index(qx, qy), *i);
+  }
+  std::sort(keys.begin(), keys.end());
+  for (const auto& key : keys)
+  {
+    *first++ = key.second;
+  }
+}
+
+// Get the indices of points sorted along a Hilbert curve.
+template <class Point>
+std::vector<std::size_t> hilbert_order(const std::vector<Point>& points)
+{
+  std::vector<std::size_t> order(points.size());
+  std::iota(order.begin(), order.end(), std::size_t(0));
+  hilbert_sort(points, order.begin(), order.end());
+  return order;
+}
+
+// Get the indices of points in a biased randomized insertion order
+// (BRIO).
+// The points are randomly shuffled and split into rounds whose sizes
+// double from one round to the next (so the last round holds about half
+// of the points).  Each round is then sorted along a Hilbert curve.
+// This keeps the randomness needed for good expected behaviour of
+// incremental constructions while preserving most of the locality of a
+// pure spatial sort.
+template <class Point>
+std::vector<std::size_t> brio_order(const std::vector<Point>& points,
+  unsigned seed = 0)
+{
+  constexpr std::size_t min_round_size = 64;
+
+  std::vector<std::size_t> order(points.size());
+  std::iota(order.begin(), order.end(), std::size_t(0));
+  std::mt19937 generator(seed);
+  std::shuffle(order.begin(), order.end(), generator);
+
+  std::size_t end = order.size();
+  while (end > min_round_size)
+  {
+    const std::size_t begin = end / 2;
+    hilbert_sort(points, order.begin() + begin, order.begin() + end);
+    end = begin;
+  }
+  hilbert_sort(points, order.begin(), order.begin() + end);
+  return order;
+}
+
+}
+
+#endif
@@ -0,0 +1,390 @@
+#ifndef triangulation_update_hpp
+#define triangulation_update_hpp
+
+#include "kernel.hpp"
+#include "lop.hpp"
+#include "point_location.hpp"
+#include <cassert>
+#include <cstddef>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace ra::geometry{
+
+namespace detail{
+
+// Append to suspects the edges incident on and opposite to the vertex,
+// which are the only edges whose quadrilaterals contain it.
+template <class Vertex_handle, class Halfedge_handle>
+void add_star_edges(Vertex_handle vertex,
+  std::vector<Halfedge_handle>& suspects)
+{
+  // Circulate over the halfedges whose target is the vertex.
+  const auto first = vertex->halfedge();
+  auto h = first;
+  do
+  {
+    suspects.push_back(h);
+    if (!h->is_border())
+    {
+      suspects.push_back(h->next()->next());
+    }
+    h = h->next()->opposite();
+  } while (h != first);
+}
+
+// Add a vertex at the point p outside the convex border of the
+// triangulation tri, connected to all the border edges that have p
+// strictly on their outer side, starting from one such border halfedge h.
+// Get a halfedge whose target is the new vertex.
+template <class R, class Triangulation>
+typename Triangulation::Halfedge_handle add_outside_vertex(Kernel<R>& kernel,
+  Triangulation& tri, typename Triangulation::Halfedge_handle h,
+  const typename Triangulation::Point& p)
+{
+  using Orientation = typename Kernel<R>::Orientation;
+  const auto visible = [&](typename Triangulation::Halfedge_handle e) {
+    return kernel.orientation(e->opposite()->vertex()->point(),
+      e->vertex()->point(), p) == Orientation::left_turn;
+  };
+
+  // Since the border is convex, the visible border edges are consecutive
+  // (and do not make up the whole border).
+  while (visible(h->prev()))
+  {
+    h = h->prev();
+  }
+  std::vector<typename Triangulation::Halfedge_handle> chain;
+  for (auto e = h; visible(e); e = e->next())
+  {
+    chain.push_back(e);
+  }
+  const auto result = tri.add_vertex_to_border(chain.front(), p);
+  auto border = result->opposite();
+  for (std::size_t i = 1; i < chain.size(); ++i)
+  {
+    border = tri.add_face_to_border(border);
+  }
+  return result;
+}
+
+// Split the polygonal face of the halfedge h of the triangulation tri
+// into triangles, by cutting off ears (a corner whose closed triangle
+// contains no other vertex of the polygon), and append the edges of the
+// polygon and the new edges to suspects.
+// Since polygons have few vertices here (as many as the degree of the
+// removed vertex), the quadratic search for ears is cheap.
+template <class R, class Triangulation>
+void triangulate_face(Kernel<R>& kernel, Triangulation& tri,
+  typename Triangulation::Halfedge_handle h,
+  std::vector<typename Triangulation::Halfedge_handle>& suspects)
+{
+  using Orientation = typename Kernel<R>::Orientation;
+
+  std::vector<typename Triangulation::Halfedge_handle> polygon;
+  auto e = h;
+  do
+  {
+    polygon.push_back(e);
+    suspects.push_back(e);
+    e = e->next();
+  } while (e != h);
+
+  std::size_t i = 0;
+  std::size_t misses = 0;
+  while (polygon.size() > 3)
+  {
+    // Test whether the corner at the target of polygon[i] is an ear.
+    const std::size_t n = polygon.size();
+    const std::size_t next = (i + 1) % n;
+    const std::size_t prev = (i + n - 1) % n;
+    const auto& a = polygon[i]->opposite()->vertex()->point();
+    const auto& b = polygon[i]->vertex()->point();
+    const auto& c = polygon[next]->vertex()->point();
+    bool ear = kernel.orientation(a, b, c) == Orientation::left_turn;
+    for (std::size_t j = (next + 1) % n; ear && j != prev; j = (j + 1) % n)
+    {
+      const auto& q = polygon[j]->vertex()->point();
+      ear = kernel.orientation(a, b, q) == Orientation::right_turn ||
+        kernel.orientation(b, c, q) == Orientation::right_turn ||
+        kernel.orientation(c, a, q) == Orientation::right_turn;
+    }
+    if (!ear)
+    {
+      // Every simple polygon has an ear, so a full round of corners
+      // without one means that the polygon is not simple.
+      ++misses;
+      assert(misses <= n);
+      if (misses > n)
+      {
+        std::abort();
+      }
+      i = next;
+      continue;
+    }
+    // Cut off the triangle abc with a new edge from c to a.
+    const auto diagonal = tri.split_face(polygon[next], polygon[prev]);
+    suspects.push_back(diagonal);
+    misses = 0;
+    polygon[i] = diagonal->opposite();
+    polygon.erase(polygon.begin() + next);
+    i = (next == 0 ? i - 1 : i) % polygon.size();
+  }
+}
+
+// Make the border of the triangulation tri convex again after removing a
+// vertex from it, by adding a face in each concave corner between the
+// count consecutive border halfedges starting with first, and append
+// these halfedges and the new border halfedges to suspects.
+// This is a Graham scan over the border halfedges, and the corners are
+// checked again (backwards) as faces are added.
+template <class R, class Triangulation>
+void fill_border(Kernel<R>& kernel, Triangulation& tri,
+  typename Triangulation::Halfedge_handle first, std::size_t count,
+  std::vector<typename Triangulation::Halfedge_handle>& suspects)
+{
+  using Orientation = typename Kernel<R>::Orientation;
+
+  auto e = first;
+  for (std::size_t i = 0; i < count; ++i, e = e->next())
+  {
+    suspects.push_back(e);
+  }
+  // The border halfedges from e to the end of the range (remaining in
+  // number) are still to be checked.
+  e = first;
+  std::size_t remaining = count;
+  while (remaining >= 2)
+  {
+    if (kernel.orientation(e->opposite()->vertex()->point(),
+      e->vertex()->point(), e->next()->vertex()->point()) !=
+      Orientation::left_turn)
+    {
+      e = e->next();
+      --remaining;
+      continue;
+    }
+    const auto border = tri.add_face_to_border(e);
+    suspects.push_back(border);
+    if (e == first)
+    {
+      first = border;
+      e = border;
+      --remaining;
+    }
+    else
+    {
+      e = border->prev();
+    }
+  }
+}
+
+}
+
+// Test whether the vertex vertex of the triangulation can be moved to the
+// point p without changing the topology of the triangulation, that is,
+// whether all the faces incident on it remain counterclockwise and (if
+// it is on the border) the border remains convex.
+// The type Triangulation must provide the interface of
+// trilib::Triangulation_2.
+template <class Triangulation>
+bool can_move_vertex(typename Triangulation::Vertex_const_handle vertex,
+  const typename Triangulation::Point& p)
+{
+  using Predicates = Kernel<typename Triangulation::Kernel::FT>;
+  using Orientation = typename Predicates::Orientation;
+
+  Predicates kernel;
+  // Circulate over the halfedges whose target is the vertex.
+  const auto first = vertex->halfedge();
+  auto h = first;
+  do
+  {
+    if (h->is_border())
+    {
+      // The border turns at the previous vertex a, at the vertex, and at
+      // the next vertex b.
+      const auto& a = h->opposite()->vertex()->point();
+      const auto& b = h->next()->vertex()->point();
+      if (kernel.orientation(h->prev()->opposite()->vertex()->point(), a,
+        p) == Orientation::left_turn || kernel.orientation(a, p, b) ==
+        Orientation::left_turn || kernel.orientation(p, b,
+        h->next()->next()->vertex()->point()) == Orientation::left_turn)
+      {
+        return false;
+      }
+    }
+    else if (kernel.orientation(h->opposite()->vertex()->point(), p,
+      h->next()->vertex()->point()) != Orientation::left_turn)
+    {
+      return false;
+    }
+    h = h->next()->opposite();
+  } while (h != first);
+  return true;
+}
+
+// The result of move_vertices.
+template <class Triangulation>
+struct Vertex_moves
+{
+  // The vertices that were not moved, because the move would have
+  // changed the topology of the triangulation (see can_move_vertex); such
+  // a vertex can be moved by removing it and inserting a new one (see
+  // remove_vertex and insert_vertex).
+  std::vector<typename Triangulation::Vertex_handle> rejected;
+  // The statistics of the LOP that restored the preferred-directions
+  // Delaunay property.
+  Lop_statistics lop;
+};
+
+// Move vertices of the PD-Delaunay triangulation tri (with respect to the
+// first and second directions u and v) to new positions, and restore the
+// preferred-directions Delaunay property.
+// Each element of moves is a vertex and its new position.  The moves are
+// made in order, and each is made only if it keeps the topology valid
+// (given the moves made before it).  Only the edges whose quadrilaterals
+// contain a moved vertex can lose the preferred-directions
+// locally-Delaunay property, so the LOP starts with these (the edges
+// incident on and opposite to the moved vertices); the cost is
+// proportional to the number of moves and flips rather than to the size
+// of tri.
+// The type Triangulation must provide the interface of
+// trilib::Triangulation_2.
+// Precondition: The triangulation is PD-Delaunay with respect to u and v,
+// which satisfy the preconditions of make_pd_delaunay.
+template <class Triangulation>
+Vertex_moves<Triangulation> move_vertices(Triangulation& tri,
+  const std::vector<std::pair<typename Triangulation::Vertex_handle,
+  typename Triangulation::Point>>& moves,
+  const typename Triangulation::Kernel::Vector_2& u,
+  const typename Triangulation::Kernel::Vector_2& v)
+{
+  Vertex_moves<Triangulation> result;
+  std::vector<typename Triangulation::Halfedge_handle> suspects;
+  for (const auto& move : moves)
+  {
+    const auto vertex = move.first;
+    if (!can_move_vertex<Triangulation>(vertex, move.second))
+    {
+      result.rejected.push_back(vertex);
+      continue;
+    }
+    vertex->point() = move.second;
+    detail::add_star_edges(vertex, suspects);
+  }
+  result.lop = restore_pd_delaunay(tri, u, v, std::move(suspects));
+  return result;
+}
+
+// Insert the point p into the PD-Delaunay triangulation tri (with respect
+// to the first and second directions u and v), and restore the
+// preferred-directions Delaunay property.
+// The point is located by walking from the halfedge hint (see walk_to),
+// so the cost is that of the walk plus O(d) for a new vertex of degree d
+// (and the flips, which are O(1) amortized for random insertions).  A
+// good hint is a halfedge of a vertex inserted nearby (e.g., the previous
+// point, when the points are inserted along a Hilbert curve), or a
+// halfedge found by a Point_locator.
+// If p is in the interior of a face, the face is split into three; if it
+// is on an edge, the edge is split (along with its faces); if it is
+// outside the convex hull, the new vertex is connected to the border
+// edges that it sees.  The LOP then starts with the edges incident on and
+// opposite to the new vertex.
+// Return value: The new vertex, or the existing vertex at p (in which case
+// the triangulation is unchanged).
+// The type Triangulation must provide the interface of
+// trilib::Triangulation_2.
+// Precondition: The triangulation is PD-Delaunay with respect to u and v,
+// which satisfy the preconditions of make_pd_delaunay.
+template <class Triangulation>
+typename Triangulation::Vertex_handle insert_vertex(Triangulation& tri,
+  const typename Triangulation::Point& p,
+  typename Triangulation::Halfedge_handle hint,
+  const typename Triangulation::Kernel::Vector_2& u,
+  const typename Triangulation::Kernel::Vector_2& v)
+{
+  Kernel<typename Triangulation::Kernel::FT> kernel;
+  const auto location = walk_to(kernel, hint, p);
+  typename Triangulation::Halfedge_handle h;
+  switch (location.type)
+  {
+  case Locate_type::vertex:
+    return location.halfedge->vertex();
+  case Locate_type::edge:
+    h = tri.split_edge(location.halfedge, p);
+    break;
+  case Locate_type::face:
+    h = tri.create_center_vertex(location.halfedge, p);
+    break;
+  case Locate_type::outside:
+    h = detail::add_outside_vertex(kernel, tri, location.halfedge, p);
+    break;
+  }
+  const auto vertex = h->vertex();
+  std::vector<typename Triangulation::Halfedge_handle> suspects;
+  detail::add_star_edges(vertex, suspects);
+  restore_pd_delaunay(tri, u, v, std::move(suspects));
+  return vertex;
+}
+
+// Insert the point p into the PD-Delaunay triangulation tri as above,
+// walking from an arbitrary halfedge.
+template <class Triangulation>
+typename Triangulation::Vertex_handle insert_vertex(Triangulation& tri,
+  const typename Triangulation::Point& p,
+  const typename Triangulation::Kernel::Vector_2& u,
+  const typename Triangulation::Kernel::Vector_2& v)
+{
+  return insert_vertex(tri, p, tri.halfedges_begin(), u, v);
+}
+
+// Remove the vertex vertex from the PD-Delaunay triangulation tri (with
+// respect to the first and second directions u and v), and restore the
+// preferred-directions Delaunay property.
+// If the vertex is in the interior, the hole left by it is triangulated
+// by cutting off ears; if it is on the border, faces are added in the
+// concave corners of the new border until the border is convex again.
+// The LOP then starts with the edges of the hole and the new edges.  The
+// cost is O(d^2) for a vertex of degree d (plus the flips), which is O(1)
+// on average, since the average degree is less than six.
+// The type Triangulation must provide the interface of
+// trilib::Triangulation_2.
+// Precondition: The triangulation is PD-Delaunay with respect to u and v,
+// which satisfy the preconditions of make_pd_delaunay, and the vertices
+// other than vertex are not all collinear.
+template <class Triangulation>
+void remove_vertex(Triangulation& tri,
+  typename Triangulation::Vertex_handle vertex,
+  const typename Triangulation::Kernel::Vector_2& u,
+  const typename Triangulation::Kernel::Vector_2& v)
+{
+  Kernel<typename Triangulation::Kernel::FT> kernel;
+  std::size_t degree = 0;
+  bool on_border = false;
+  const auto first = vertex->halfedge();
+  auto h = first;
+  do
+  {
+    ++degree;
+    on_border = on_border || h->is_border();
+    h = h->next()->opposite();
+  } while (h != first);
+
+  std::vector<typename Triangulation::Halfedge_handle> suspects;
+  h = tri.erase_center_vertex(vertex);
+  if (on_border)
+  {
+    detail::fill_border(kernel, tri, h, degree - 1, suspects);
+  }
+  else
+  {
+    detail::triangulate_face(kernel, tri, h, suspects);
+  }
+  restore_pd_delaunay(tri, u, v, std::move(suspects));
+}
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef voronoi_hpp
+#define voronoi_hpp
+
+#include "kernel.hpp"
+#include <unordered_map>
+#include <vector>
+
+namespace ra::geometry{
+
+// A Voronoi diagram, as the dual of a (Delaunay) triangulation.
+template <class R>
+struct Voronoi_diagram
+{
+  // The geometry kernel used for the constructions.
+  using Kernel = ra::geometry::Kernel<R>;
+  // The type used to represent vectors in two dimensions.
+  using Vector = typename Kernel::Vector;
+
+  // An edge of the diagram, dual to an edge of the triangulation.
+  // A bounded edge joins the vertices with the indices source and target.
+  // An unbounded edge (dual to an edge on the convex hull) is a ray that
+  // starts at the vertex with the index source and goes in the direction
+  // direction; its target is -1.
+  struct Edge
+  {
+    int source;
+    int target;
+    Vector direction;
+  };
+
+  // The vertices of the diagram, that is, the circumcenters of the faces
+  // of the triangulation (in the order in which the faces are iterated),
+  // with certified error bounds.
+  std::vector<typename Kernel::Approximate_point> vertices;
+  // The edges of the diagram.
+  std::vector<Edge> edges;
+};
+
+// Get the Voronoi diagram dual to the triangulation tri, in a single pass
+// over its faces.
+// The type Triangulation must provide the interface of
+// trilib::Triangulation_2.  The result is only a Voronoi diagram if tri
+// is a Delaunay triangulation; otherwise it is the same construction
+// applied to tri (and its edges may cross).
+template <class Triangulation>
+Voronoi_diagram<typename Triangulation::Kernel::FT> make_voronoi_diagram(
+  const Triangulation& tri)
+{
+  using Diagram = Voronoi_diagram<typename Triangulation::Kernel::FT>;
+  using Face = typename Triangulation::Face;
+
+  typename Diagram::Kernel kernel;
+  Diagram diagram;
+  diagram.vertices.reserve(tri.size_of_faces());
+  diagram.edges.reserve(tri.size_of_edges());
+
+  // The indices of the faces visited so far, by address (which, unlike a
+  // face handle, can be hashed).
+  std::unordered_map<const Face*, int> index;
+  index.reserve(tri.size_of_faces());
+  for (auto f = tri.faces_begin(); f != tri.faces_end(); ++f)
+  {
+    const int i = int(diagram.vertices.size());
+    auto h = f->halfedge();
+    diagram.vertices.push_back(kernel.circumcenter(h->vertex()->point(),
+      h->next()->vertex()->point(), h->next()->next()->vertex()->point()));
+    for (int k = 0; k < 3; ++k, h = h->next())
+    {
+      if (h->opposite()->is_border())
+      {
+        // The face is to the left of the hull edge st, so the ray goes
+        // to the right of it.
+        const auto& s = h->opposite()->vertex()->point();
+        const auto& t = h->vertex()->point();
+        diagram.edges.push_back({i, -1,
+          typename Diagram::Vector(t.y() - s.y(), s.x() - t.x())});
+      }
+      else
+      {
+        // Each bounded edge is added when its second face is visited.
+        const auto j = index.find(&*h->opposite()->face());
+        if (j != index.end())
+        {
+          diagram.edges.push_back({j->second, i,
+            typename Diagram::Vector(0, 0)});
+        }
+      }
+    }
+    index.emplace(&*f, i);
+  }
+  return diagram;
+}
+
+}
+
+#endif